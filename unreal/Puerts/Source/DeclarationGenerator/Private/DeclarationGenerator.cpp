@@ -680,6 +680,12 @@ void FTypeScriptDeclarationGenerator::GenStruct(UStruct *Struct)
     }
 
     StringBuffer << "    static StaticClass(): Class;\n";
+    FString StructName = SafeName(Struct->GetName());
+    StringBuffer << "    static toPlain(Value: " << StructName << "): Partial<" << StructName << ">;\n";
+    StringBuffer << "    static fromPlain(Value: " << StructName << ", Plain: Partial<" << StructName << ">): void;\n";
+    StringBuffer << "    static toBuffer(Value: " << StructName << ", Buffer?: ArrayBuffer | ArrayBufferView): ArrayBuffer | ArrayBufferView;\n";
+    StringBuffer << "    static fromBuffer(Value: " << StructName << ", Buffer: ArrayBuffer | ArrayBufferView): void;\n";
+    StringBuffer << "    static bufferLayout(): {[Field: string]: number};\n";
     
     StringBuffer << "}\n\n";
     
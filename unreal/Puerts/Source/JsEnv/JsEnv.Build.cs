@@ -21,6 +21,15 @@ public class JsEnv : ModuleRules
 
     private bool WithFFI = false;
 
+    // 对非网络的C++ UFunction直接调用Func，不经过ProcessEvent
+    private bool DirectNativeCall = true;
+
+    // UObject到js对象的映射用GUObjectArray下标做索引的数组，对象较多时查找更快，但内存占用和GUObjectArray大小相关
+    private bool ObjectMapByIndex = false;
+
+    // UClass/UScriptStruct的属性和成员函数在第一次访问时才创建translator并装到原型上，类多的项目可减少启动时间和内存，但不支持对原型做for in枚举
+    private bool LazyAccessor = false;
+
     public JsEnv(ReadOnlyTargetRules Target) : base(Target)
     {
         //PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
@@ -32,6 +41,8 @@ public class JsEnv : ModuleRules
 
         //Definitions.Add("WITH_INSPECTOR");
 
+        //Definitions.Add("USE_FAST_CALL");
+
         bEnableExceptions = true;
         bEnableUndefinedIdentifierWarnings = false; // 避免在VS 2017编译时出现C4668错误
         var ContextField = GetType().GetField("Context", BindingFlags.Instance | BindingFlags.NonPublic);
@@ -59,6 +70,12 @@ public class JsEnv : ModuleRules
         
         if (WithFFI) AddFFI(Target);
 
+        if (!DirectNativeCall) Definitions.Add("WITHOUT_DIRECT_NATIVE_CALL");
+
+        if (ObjectMapByIndex) Definitions.Add("OBJECT_MAP_BY_INDEX");
+
+        if (LazyAccessor) Definitions.Add("LAZY_ACCESSOR");
+
         string coreJSPath = Path.GetFullPath(Path.Combine(ModuleDirectory, "..", "..", "Content"));
         string destDirName = Path.GetFullPath(Path.Combine(ModuleDirectory, "..", "..", "..", "..", "Content"));
         DirectoryCopy(coreJSPath, destDirName, true);
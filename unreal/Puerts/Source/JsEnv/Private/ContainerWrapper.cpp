@@ -7,6 +7,7 @@
 
 #include "ContainerWrapper.h"
 #include "PropertyTranslator.h"
+#include "Algo/StableSort.h"
 
 namespace puerts
 {
@@ -19,12 +20,327 @@ namespace puerts
 #endif
     }
 
+    // 先整体转成js数组，再返回数组自带的迭代器，遍历过程中不再跨越边界
+    static void ReturnArrayIterator(const v8::FunctionCallbackInfo<v8::Value>& Info, v8::Local<v8::Context> Context, v8::Local<v8::Array> Array)
+    {
+#ifndef WITH_QUICKJS
+        v8::Local<v8::Value> IteratorFunction;
+        v8::Local<v8::Value> Result;
+        if (Array->Get(Context, v8::Symbol::GetIterator(Info.GetIsolate())).ToLocal(&IteratorFunction) && IteratorFunction->IsFunction()
+            && v8::Local<v8::Function>::Cast(IteratorFunction)->Call(Context, Array, 0, nullptr).ToLocal(&Result))
+        {
+            Info.GetReturnValue().Set(Result);
+        }
+#endif
+    }
+
+    // 数值（含枚举）、FName、FString作为元素或者键时，直接用具体类型在栈上构造临时变量，
+    // 哈希和比较也直接调用，省掉InitializeValue/DestroyValue以及查找过程中每次GetValueTypeHash/Identical的虚调用
+    enum class EFastKey : uint8
+    {
+        None,
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        Float,
+        Double,
+        Name,
+        String,
+    };
+
+    static EFastKey GetFastKey(PropertyMacro* Property)
+    {
+        if (Property->IsA<NamePropertyMacro>()) return EFastKey::Name;
+        if (Property->IsA<StrPropertyMacro>()) return EFastKey::String;
+        if (Property->IsA<IntPropertyMacro>()) return EFastKey::Int32;
+        if (Property->IsA<BytePropertyMacro>()) return EFastKey::UInt8;
+        if (Property->IsA<FloatPropertyMacro>()) return EFastKey::Float;
+        if (Property->IsA<Int64PropertyMacro>()) return EFastKey::Int64;
+        if (Property->IsA<DoublePropertyMacro>()) return EFastKey::Double;
+        if (Property->IsA<UInt32PropertyMacro>()) return EFastKey::UInt32;
+        if (Property->IsA<UInt64PropertyMacro>()) return EFastKey::UInt64;
+        if (Property->IsA<Int16PropertyMacro>()) return EFastKey::Int16;
+        if (Property->IsA<UInt16PropertyMacro>()) return EFastKey::UInt16;
+        if (Property->IsA<Int8PropertyMacro>()) return EFastKey::Int8;
+        if (EnumPropertyMacro* EnumProperty = CastFieldMacro<EnumPropertyMacro>(Property))
+        {
+            return GetFastKey(EnumProperty->GetUnderlyingProperty());
+        }
+        return EFastKey::None;
+    }
+
+    // 和对应Property的GetValueTypeHash、Identical保持一致
+    template<typename T>
+    struct TFastKeyOps
+    {
+        FORCEINLINE static uint32 Hash(const void* Element)
+        {
+            return GetTypeHash(*static_cast<const T*>(Element));
+        }
+
+        FORCEINLINE static bool Equals(const void* A, const void* B)
+        {
+            return *static_cast<const T*>(A) == *static_cast<const T*>(B);
+        }
+    };
+
+    template<typename T>
+    struct TFindInArray
+    {
+        static int32 Run(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, v8::Local<v8::Value> Value, FPropertyTranslator* Translator, FScriptArray* ScriptArray)
+        {
+            T Key = T();
+            Translator->JsToUE(Isolate, Context, Value, &Key, false);
+            const T* Data = static_cast<const T*>(ScriptArray->GetData());
+            const int32 Num = ScriptArray->Num();
+            for (int32 i = 0; i < Num; ++i)
+            {
+                if (Data[i] == Key)
+                {
+                    return i;
+                }
+            }
+            return INDEX_NONE;
+        }
+    };
+
+    template<typename T>
+    struct TFindInSet
+    {
+        static int32 Run(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, v8::Local<v8::Value> Value, FPropertyTranslator* Translator, FScriptSet* ScriptSet, const FScriptSetLayout& ScriptLayout)
+        {
+            T Key = T();
+            Translator->JsToUE(Isolate, Context, Value, &Key, false);
+            return ScriptSet->FindIndex(&Key, ScriptLayout,
+                [](const void* Element) { return TFastKeyOps<T>::Hash(Element); },
+                [](const void* A, const void* B) { return TFastKeyOps<T>::Equals(A, B); }
+            );
+        }
+    };
+
+    template<typename T>
+    struct TFindInMap
+    {
+        static int32 Run(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, v8::Local<v8::Value> Value, FPropertyTranslator* Translator, FScriptMap* ScriptMap, const FScriptMapLayout& ScriptLayout)
+        {
+            T Key = T();
+            Translator->JsToUE(Isolate, Context, Value, &Key, false);
+            return ScriptMap->FindPairIndex(&Key, ScriptLayout,
+                [](const void* Element) { return TFastKeyOps<T>::Hash(Element); },
+                [](const void* A, const void* B) { return TFastKeyOps<T>::Equals(A, B); }
+            );
+        }
+    };
+
+    template<typename T>
+    struct TSortLess
+    {
+        FORCEINLINE bool operator()(const T& A, const T& B) const
+        {
+            return A < B;
+        }
+    };
+
+    // NaN和谁比都是false，不满足严格弱序，统一排到最后，NaN之间保持原顺序
+    template<typename T>
+    struct TFloatSortLess
+    {
+        FORCEINLINE bool operator()(T A, T B) const
+        {
+            return !FMath::IsNaN(A) && (FMath::IsNaN(B) || A < B);
+        }
+    };
+
+    template<>
+    struct TSortLess<float> : TFloatSortLess<float> {};
+
+    template<>
+    struct TSortLess<double> : TFloatSortLess<double> {};
+
+    // 和传比较函数时一样用稳定排序，FName、FString的<不区分大小写，相等的元素保持原顺序
+    template<typename T>
+    struct TSortArray
+    {
+        static int32 Run(FScriptArray* ScriptArray)
+        {
+            Algo::StableSort(MakeArrayView(static_cast<T*>(ScriptArray->GetData()), ScriptArray->Num()), TSortLess<T>());
+            return 0;
+        }
+    };
+
+    template<template<typename> class TOp, typename... TArgs>
+    static int32 DispatchFastKey(EFastKey FastKey, TArgs&&... Args)
+    {
+        switch (FastKey)
+        {
+        case EFastKey::Int8: return TOp<int8>::Run(Forward<TArgs>(Args)...);
+        case EFastKey::UInt8: return TOp<uint8>::Run(Forward<TArgs>(Args)...);
+        case EFastKey::Int16: return TOp<int16>::Run(Forward<TArgs>(Args)...);
+        case EFastKey::UInt16: return TOp<uint16>::Run(Forward<TArgs>(Args)...);
+        case EFastKey::Int32: return TOp<int32>::Run(Forward<TArgs>(Args)...);
+        case EFastKey::UInt32: return TOp<uint32>::Run(Forward<TArgs>(Args)...);
+        case EFastKey::Int64: return TOp<int64>::Run(Forward<TArgs>(Args)...);
+        case EFastKey::UInt64: return TOp<uint64>::Run(Forward<TArgs>(Args)...);
+        case EFastKey::Float: return TOp<float>::Run(Forward<TArgs>(Args)...);
+        case EFastKey::Double: return TOp<double>::Run(Forward<TArgs>(Args)...);
+        case EFastKey::Name: return TOp<FName>::Run(Forward<TArgs>(Args)...);
+        case EFastKey::String: return TOp<FString>::Run(Forward<TArgs>(Args)...);
+        default: return INDEX_NONE;
+        }
+    }
+
+    enum class ETypedArrayElement : uint8
+    {
+        None,
+        Int8,
+        Uint8,
+        Int16,
+        Uint16,
+        Int32,
+        Uint32,
+        Float32,
+        Float64,
+    };
+
+    static int32 GetTypedArrayElementSize(ETypedArrayElement Type)
+    {
+        switch (Type)
+        {
+        case ETypedArrayElement::Int8:
+        case ETypedArrayElement::Uint8:
+            return 1;
+        case ETypedArrayElement::Int16:
+        case ETypedArrayElement::Uint16:
+            return 2;
+        case ETypedArrayElement::Int32:
+        case ETypedArrayElement::Uint32:
+        case ETypedArrayElement::Float32:
+            return 4;
+        case ETypedArrayElement::Float64:
+            return 8;
+        default:
+            return 0;
+        }
+    }
+
+    static v8::Local<v8::TypedArray> NewTypedArray(ETypedArrayElement Type, v8::Local<v8::ArrayBuffer> Ab, size_t Length)
+    {
+        switch (Type)
+        {
+        case ETypedArrayElement::Int8:
+            return v8::Int8Array::New(Ab, 0, Length);
+        case ETypedArrayElement::Uint8:
+            return v8::Uint8Array::New(Ab, 0, Length);
+        case ETypedArrayElement::Int16:
+            return v8::Int16Array::New(Ab, 0, Length);
+        case ETypedArrayElement::Uint16:
+            return v8::Uint16Array::New(Ab, 0, Length);
+        case ETypedArrayElement::Int32:
+            return v8::Int32Array::New(Ab, 0, Length);
+        case ETypedArrayElement::Uint32:
+            return v8::Uint32Array::New(Ab, 0, Length);
+        case ETypedArrayElement::Float32:
+            return v8::Float32Array::New(Ab, 0, Length);
+        default:
+            return v8::Float64Array::New(Ab, 0, Length);
+        }
+    }
+
+    static bool IsTypedArrayOf(ETypedArrayElement Type, v8::Local<v8::Value> Value)
+    {
+        switch (Type)
+        {
+        case ETypedArrayElement::Int8:
+            return Value->IsInt8Array();
+        case ETypedArrayElement::Uint8:
+            return Value->IsUint8Array();
+        case ETypedArrayElement::Int16:
+            return Value->IsInt16Array();
+        case ETypedArrayElement::Uint16:
+            return Value->IsUint16Array();
+        case ETypedArrayElement::Int32:
+            return Value->IsInt32Array();
+        case ETypedArrayElement::Uint32:
+            return Value->IsUint32Array();
+        case ETypedArrayElement::Float32:
+            return Value->IsFloat32Array();
+        case ETypedArrayElement::Float64:
+            return Value->IsFloat64Array();
+        default:
+            return false;
+        }
+    }
+
+    static ETypedArrayElement GetScalarElementType(PropertyMacro* Property)
+    {
+        if (Property->IsA<FloatPropertyMacro>()) return ETypedArrayElement::Float32;
+        if (Property->IsA<DoublePropertyMacro>()) return ETypedArrayElement::Float64;
+        if (Property->IsA<IntPropertyMacro>()) return ETypedArrayElement::Int32;
+        if (Property->IsA<UInt32PropertyMacro>()) return ETypedArrayElement::Uint32;
+        if (Property->IsA<Int16PropertyMacro>()) return ETypedArrayElement::Int16;
+        if (Property->IsA<UInt16PropertyMacro>()) return ETypedArrayElement::Uint16;
+        if (Property->IsA<Int8PropertyMacro>()) return ETypedArrayElement::Int8;
+        if (Property->IsA<BytePropertyMacro>()) return ETypedArrayElement::Uint8;
+        if (EnumPropertyMacro* EnumProperty = CastFieldMacro<EnumPropertyMacro>(Property))
+        {
+            return GetScalarElementType(EnumProperty->GetUnderlyingProperty());
+        }
+        return ETypedArrayElement::None;
+    }
+
+    // 元素是数值，或者结构体的反射字段全是同一种数值类型且刚好铺满整个结构体（FVector、FLinearColor、FIntPoint等），才能按TypedArray访问
+    static ETypedArrayElement GetTypedArrayElementType(PropertyMacro* Property, int32& Components)
+    {
+        StructPropertyMacro* StructProperty = CastFieldMacro<StructPropertyMacro>(Property);
+        if (!StructProperty)
+        {
+            Components = 1;
+            return GetScalarElementType(Property);
+        }
+
+        ETypedArrayElement Result = ETypedArrayElement::None;
+        int32 CoveredSize = 0;
+        for (TFieldIterator<PropertyMacro> It(StructProperty->Struct); It; ++It)
+        {
+            ETypedArrayElement FieldType = GetScalarElementType(*It);
+            if (FieldType == ETypedArrayElement::None || (Result != ETypedArrayElement::None && FieldType != Result))
+            {
+                return ETypedArrayElement::None;
+            }
+            Result = FieldType;
+            CoveredSize += It->ElementSize * It->ArrayDim;
+        }
+        if (Result == ETypedArrayElement::None || CoveredSize != StructProperty->Struct->GetStructureSize())
+        {
+            return ETypedArrayElement::None;
+        }
+        Components = CoveredSize / GetTypedArrayElementSize(Result);
+        return Result;
+    }
+
+    void FScriptArrayWrapper::New(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        FContinerWrapper<FScriptArray>::New(Info);
+#ifndef WITH_QUICKJS
+        v8::Isolate* Isolate = Info.GetIsolate();
+        if (Info.Length() == 2 && Info[0]->IsExternal())
+        {
+            Info.This()->SetInternalField(5, v8::Boolean::New(Isolate, !Info[1]->BooleanValue(Isolate)));
+        }
+#endif
+    }
+
     v8::Local<v8::FunctionTemplate> FScriptArrayWrapper::ToFunctionTemplate(v8::Isolate* Isolate)
     {
         v8::Isolate::Scope Isolatescope(Isolate);
         v8::EscapableHandleScope HandleScope(Isolate);
         auto Result = v8::FunctionTemplate::New(Isolate, New);
-        Result->InstanceTemplate()->SetInternalFieldCount(4);//0 Ptr, 1 Property
+        Result->InstanceTemplate()->SetInternalFieldCount(6);//0 Ptr, 1 Property, 4 TypedArray View, 5 Owned
 
         Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Num"), v8::FunctionTemplate::New(Isolate, Num));
         Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Add"), v8::FunctionTemplate::New(Isolate, Add));
@@ -35,6 +351,19 @@ namespace puerts
         Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "RemoveAt"), v8::FunctionTemplate::New(Isolate, RemoveAt));
         Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "IsValidIndex"), v8::FunctionTemplate::New(Isolate, IsValidIndex));
         Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Empty"), v8::FunctionTemplate::New(Isolate, Empty));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "toTypedArray"), v8::FunctionTemplate::New(Isolate, ToTypedArray));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "asTypedArrayView"), v8::FunctionTemplate::New(Isolate, AsTypedArrayView));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "setFromTypedArray"), v8::FunctionTemplate::New(Isolate, SetFromTypedArray));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "forEach"), v8::FunctionTemplate::New(Isolate, ForEach));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "toArray"), v8::FunctionTemplate::New(Isolate, ToArray));
+#ifndef WITH_QUICKJS
+        Result->PrototypeTemplate()->Set(v8::Symbol::GetIterator(Isolate), v8::FunctionTemplate::New(Isolate, Iterator));
+#endif
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Reserve"), v8::FunctionTemplate::New(Isolate, Reserve));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Append"), v8::FunctionTemplate::New(Isolate, Append));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "SetNum"), v8::FunctionTemplate::New(Isolate, SetNum));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Shrink"), v8::FunctionTemplate::New(Isolate, Shrink));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Sort"), v8::FunctionTemplate::New(Isolate, Sort));
 
         return HandleScope.Escape(Result);
     }
@@ -50,6 +379,7 @@ namespace puerts
             auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
             auto Inner = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
             
+            DetachView(Info.Holder());
             int32 Index = AddUninitialized(Self, Inner->Property->GetSize(), Info.Length());
             for (int i = 0; i < Info.Length(); ++i)
             {
@@ -136,38 +466,449 @@ namespace puerts
             FV8Utils::ThrowException(Isolate, TEXT("invalid index"));
             return;
         }
-        else
+        else
+        {
+            DetachView(Info.Holder());
+            Destruct(Self, PropertyTranslator, Index, 1);
+            Self->Remove(Index, 1, Property->GetSize());
+        }
+    }
+
+    void FScriptArrayWrapper::IsValidIndex(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        CHECK_V8_ARGS_LEN(1);
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
+        int32 Index = Info[0]->Int32Value(Context).ToChecked();
+        Info.GetReturnValue().Set(Self->IsValidIndex(Index));
+    }
+
+    void FScriptArrayWrapper::Empty(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
+        auto PropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+        auto Property = PropertyTranslator->Property;
+
+        DetachView(Info.Holder());
+        Destruct(Self, PropertyTranslator, 0, Self->Num());
+        Self->Empty(0, Property->GetSize());
+    }
+
+    void FScriptArrayWrapper::ToTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
+        auto Inner = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+
+        int32 Components = 1;
+        ETypedArrayElement Type = GetTypedArrayElementType(Inner->Property, Components);
+        if (Type == ETypedArrayElement::None)
+        {
+            FV8Utils::ThrowException(Isolate, "element type not support typed array");
+            return;
+        }
+
+        const int32 ByteLength = Self->Num() * Inner->Property->GetSize();
+        v8::Local<v8::ArrayBuffer> Ab = v8::ArrayBuffer::New(Isolate, ByteLength);
+        if (ByteLength > 0)
+        {
+            FMemory::Memcpy(Ab->GetContents().Data(), Self->GetData(), ByteLength);
+        }
+        Info.GetReturnValue().Set(NewTypedArray(Type, Ab, Self->Num() * Components));
+    }
+
+    void FScriptArrayWrapper::AsTypedArrayView(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
+        auto Inner = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+
+        int32 Components = 1;
+        ETypedArrayElement Type = GetTypedArrayElementType(Inner->Property, Components);
+        if (Type == ETypedArrayElement::None)
+        {
+            FV8Utils::ThrowException(Isolate, "element type not support typed array");
+            return;
+        }
+
+#ifndef WITH_QUICKJS
+        auto Holder = Info.Holder();
+        if (!Holder->GetInternalField(5)->IsTrue())
+        {
+            FV8Utils::ThrowException(Isolate, "asTypedArrayView only support array passed to js by value, use toTypedArray instead");
+            return;
+        }
+
+        const size_t ByteLength = Self->Num() * Inner->Property->GetSize();
+        void* Data = Self->GetData();
+
+        // 同一个容器对象只保留一个ArrayBuffer，内存没变就复用
+        v8::Local<v8::ArrayBuffer> Ab;
+        v8::Local<v8::Value> Cached = Holder->GetInternalField(4);
+        if (Cached->IsArrayBuffer())
+        {
+            auto CachedAb = v8::Local<v8::ArrayBuffer>::Cast(Cached);
+            auto Contents = CachedAb->GetContents();
+            if (Contents.Data() == Data && Contents.ByteLength() == ByteLength)
+            {
+                Ab = CachedAb;
+            }
+            else
+            {
+                CachedAb->Detach();
+            }
+        }
+        if (Ab.IsEmpty())
+        {
+            Ab = v8::ArrayBuffer::New(Isolate, Data, ByteLength);
+            // 视图存活期间容器对象不能被回收，否则容器内存会随之释放
+            Ab->SetPrivate(Context, v8::Private::ForApi(Isolate, FV8Utils::InternalString(Isolate, "puerts.container")), Holder).Check();
+            Holder->SetInternalField(4, Ab);
+        }
+        Info.GetReturnValue().Set(NewTypedArray(Type, Ab, Self->Num() * Components));
+#else
+        FV8Utils::ThrowException(Isolate, "asTypedArrayView no support yet");
+#endif
+    }
+
+    void FScriptArrayWrapper::SetFromTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        CHECK_V8_ARGS_LEN(1);
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
+        auto Inner = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+
+        int32 Components = 1;
+        ETypedArrayElement Type = GetTypedArrayElementType(Inner->Property, Components);
+        if (Type == ETypedArrayElement::None)
+        {
+            FV8Utils::ThrowException(Isolate, "element type not support typed array");
+            return;
+        }
+        if (!IsTypedArrayOf(Type, Info[0]))
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #0, typed array type mismatch");
+            return;
+        }
+
+        auto TypedArray = v8::Local<v8::TypedArray>::Cast(Info[0]);
+        const int32 Length = static_cast<int32>(TypedArray->Length());
+        if (Length % Components != 0)
+        {
+            FV8Utils::ThrowException(Isolate, FString::Printf(TEXT("Bad parameters #0, length should be a multiple of %d"), Components));
+            return;
+        }
+
+        // 能走到这里的元素都是纯数值，不需要构造和析构
+        const int32 ElementSize = Inner->Property->GetSize();
+        const int32 NewNum = Length / Components;
+        const int32 OldNum = Self->Num();
+        if (NewNum != OldNum)
+        {
+            DetachView(Info.Holder());
+            if (NewNum > OldNum)
+            {
+                AddUninitialized(Self, ElementSize, NewNum - OldNum);
+            }
+            else
+            {
+                Self->Remove(NewNum, OldNum - NewNum, ElementSize);
+            }
+        }
+        if (NewNum > 0)
+        {
+            TypedArray->CopyContents(Self->GetData(), NewNum * ElementSize);
+        }
+    }
+
+    void FScriptArrayWrapper::ForEach(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        CHECK_V8_ARGS_LEN(1);
+
+        if (!Info[0]->IsFunction())
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #0, expect a function");
+            return;
+        }
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
+        auto Inner = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+        auto Callback = v8::Local<v8::Function>::Cast(Info[0]);
+
+        // 回调里可能修改容器，每次都重新取长度和地址
+        for (int32 i = 0; i < Self->Num(); ++i)
+        {
+            v8::HandleScope ElementScope(Isolate);
+            v8::Local<v8::Value> Args[] = { Inner->UEToJs(Isolate, Context, GetData(Self, Inner->Property->GetSize(), i), true), v8::Integer::New(Isolate, i) };
+            if (Callback->Call(Context, v8::Undefined(Isolate), 2, Args).IsEmpty())
+            {
+                return;
+            }
+        }
+    }
+
+    void FScriptArrayWrapper::ToArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+
+        Info.GetReturnValue().Set(ToArrayInner(Info));
+    }
+
+    void FScriptArrayWrapper::Iterator(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        ReturnArrayIterator(Info, Context, ToArrayInner(Info));
+    }
+
+    void FScriptArrayWrapper::Reserve(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        CHECK_V8_ARGS_LEN(1);
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
+        auto Inner = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+
+        int32 Capacity = Info[0]->Int32Value(Context).ToChecked();
+        if (Capacity > Self->Num() + Self->GetSlack())
+        {
+            DetachView(Info.Holder());
+            ReserveCapacity(Self, Inner->Property->GetSize(), Capacity);
+        }
+    }
+
+    void FScriptArrayWrapper::Append(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        CHECK_V8_ARGS_LEN(1);
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
+        auto Inner = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+        auto Property = Inner->Property;
+        const int32 ElementSize = Property->GetSize();
+
+        if (Info[0]->IsArray())
+        {
+            auto JsArray = v8::Local<v8::Array>::Cast(Info[0]);
+            const int32 Count = static_cast<int32>(JsArray->Length());
+            if (Count == 0)
+            {
+                return;
+            }
+            DetachView(Info.Holder());
+            ReserveCapacity(Self, ElementSize, Self->Num() + Count);
+            int32 Index = AddUninitialized(Self, ElementSize, Count);
+            for (int32 i = 0; i < Count; ++i)
+            {
+                v8::HandleScope ElementScope(Isolate);
+                uint8 *DataPtr = GetData(Self, ElementSize, Index + i);
+                Property->InitializeValue(DataPtr);
+                v8::Local<v8::Value> Value;
+                if (JsArray->Get(Context, i).ToLocal(&Value))
+                {
+                    Inner->JsToUE(Isolate, Context, Value, DataPtr, false);
+                }
+            }
+            return;
+        }
+
+        // 同一个模板创建的容器对象原型相同，再检查元素类型
+        if (!Info[0]->IsObject() || !Info[0]->ToObject(Context).ToLocalChecked()->GetPrototype()->StrictEquals(Info.Holder()->GetPrototype()))
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #0, expect a TArray or a js array");
+            return;
+        }
+        auto OtherHolder = Info[0]->ToObject(Context).ToLocalChecked();
+        auto Other = FV8Utils::GetPoninterFast<FScriptArray>(OtherHolder, 0);
+        auto OtherInner = FV8Utils::GetPoninterFast<FPropertyTranslator>(OtherHolder, 1);
+        if (!Property->SameType(OtherInner->Property))
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #0, element type mismatch");
+            return;
+        }
+
+        const int32 Count = Other->Num();
+        if (Count == 0)
+        {
+            return;
+        }
+        DetachView(Info.Holder());
+        ReserveCapacity(Self, ElementSize, Self->Num() + Count);
+        int32 Index = AddUninitialized(Self, ElementSize, Count);
+        // Other可能就是Self，所以扩容之后才取源地址
+        for (int32 i = 0; i < Count; ++i)
+        {
+            uint8 *DataPtr = GetData(Self, ElementSize, Index + i);
+            Property->InitializeValue(DataPtr);
+            Property->CopySingleValue(DataPtr, GetData(Other, ElementSize, i));
+        }
+    }
+
+    void FScriptArrayWrapper::SetNum(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        CHECK_V8_ARGS_LEN(1);
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
+        auto Inner = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+        const int32 ElementSize = Inner->Property->GetSize();
+
+        int32 NewNum = Info[0]->Int32Value(Context).ToChecked();
+        if (NewNum < 0)
+        {
+            FV8Utils::ThrowException(Isolate, TEXT("invalid number"));
+            return;
+        }
+
+        const int32 OldNum = Self->Num();
+        if (NewNum > OldNum)
+        {
+            DetachView(Info.Holder());
+            AddUninitialized(Self, ElementSize, NewNum - OldNum);
+            Construct(Self, Inner, OldNum, NewNum - OldNum);
+        }
+        else if (NewNum < OldNum)
         {
-            Destruct(Self, PropertyTranslator, Index, 1);
-            Self->Remove(Index, 1, Property->GetSize());
+            DetachView(Info.Holder());
+            Destruct(Self, Inner, NewNum, OldNum - NewNum);
+            Self->Remove(NewNum, OldNum - NewNum, ElementSize);
         }
     }
 
-    void FScriptArrayWrapper::IsValidIndex(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    void FScriptArrayWrapper::Shrink(const v8::FunctionCallbackInfo<v8::Value>& Info)
     {
         v8::Isolate* Isolate = Info.GetIsolate();
         v8::HandleScope HandleScope(Isolate);
         v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
 
-        CHECK_V8_ARGS_LEN(1);
-
         auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
-        int32 Index = Info[0]->Int32Value(Context).ToChecked();
-        Info.GetReturnValue().Set(Self->IsValidIndex(Index));
+        auto Inner = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+
+        if (Self->GetSlack() > 0)
+        {
+            DetachView(Info.Holder());
+            Self->Shrink(Inner->Property->GetSize());
+        }
     }
 
-    void FScriptArrayWrapper::Empty(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    void FScriptArrayWrapper::Sort(const v8::FunctionCallbackInfo<v8::Value>& Info)
     {
         v8::Isolate* Isolate = Info.GetIsolate();
         v8::HandleScope HandleScope(Isolate);
         v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
 
         auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
-        auto PropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
-        auto Property = PropertyTranslator->Property;
+        auto Inner = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+        auto Property = Inner->Property;
 
-        Destruct(Self, PropertyTranslator, 0, Self->Num());
-        Self->Empty(0, Property->GetSize());
+        if (Info.Length() == 0 || Info[0]->IsUndefined())
+        {
+            EFastKey FastKey = GetFastKey(Property);
+            if (FastKey == EFastKey::None)
+            {
+                FV8Utils::ThrowException(Isolate, "Bad parameters #0, expect a function");
+                return;
+            }
+            DispatchFastKey<TSortArray>(FastKey, Self);
+            return;
+        }
+        if (!Info[0]->IsFunction())
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #0, expect a function");
+            return;
+        }
+
+        const int32 Num = Self->Num();
+        if (Num < 2)
+        {
+            return;
+        }
+
+        // 每个元素只转换一次，排序的是下标，最后再按位搬移元素，不需要构造和析构
+        const int32 ElementSize = Property->GetSize();
+        auto Compare = v8::Local<v8::Function>::Cast(Info[0]);
+        std::vector<v8::Local<v8::Value>> Values(Num);
+        for (int32 i = 0; i < Num; ++i)
+        {
+            Values[i] = Inner->UEToJs(Isolate, Context, GetData(Self, ElementSize, i), true);
+        }
+
+        TArray<int32> Order;
+        Order.SetNumUninitialized(Num);
+        for (int32 i = 0; i < Num; ++i)
+        {
+            Order[i] = i;
+        }
+
+        bool HasException = false;
+        Order.StableSort([&](int32 A, int32 B)
+        {
+            if (HasException)
+            {
+                return false;
+            }
+            v8::HandleScope CompareScope(Isolate);
+            v8::Local<v8::Value> Args[] = { Values[A], Values[B] };
+            v8::Local<v8::Value> Result;
+            double Number = 0;
+            if (!Compare->Call(Context, v8::Undefined(Isolate), 2, Args).ToLocal(&Result) || !Result->NumberValue(Context).To(&Number))
+            {
+                HasException = true;
+                return false;
+            }
+            return Number < 0;
+        });
+        if (HasException)
+        {
+            return;
+        }
+        if (Self->Num() != Num)
+        {
+            FV8Utils::ThrowException(Isolate, TEXT("array modified during sort"));
+            return;
+        }
+
+        uint8* Buffer = static_cast<uint8*>(FMemory::Malloc(Num * ElementSize));
+        for (int32 i = 0; i < Num; ++i)
+        {
+            FMemory::Memcpy(Buffer + i * ElementSize, GetData(Self, ElementSize, Order[i]), ElementSize);
+        }
+        FMemory::Memcpy(Self->GetData(), Buffer, Num * ElementSize);
+        FMemory::Free(Buffer);
     }
 
     FORCEINLINE int32 FScriptArrayWrapper::AddUninitialized(FScriptArray *ScriptArray, int32 ElementSize, int32 Count)
@@ -180,6 +921,25 @@ namespace puerts
         return reinterpret_cast<uint8*>(ScriptArray->GetData()) + Index * ElementSize;
     }
 
+    // FScriptArray没有Reserve，在新的FScriptArray上预留好空间后把元素按位搬过去（UE容器本来就要求元素可以按位搬移）
+    void FScriptArrayWrapper::ReserveCapacity(FScriptArray *ScriptArray, int32 ElementSize, int32 Capacity)
+    {
+        const int32 Num = ScriptArray->Num();
+        if (Capacity <= Num + ScriptArray->GetSlack())
+        {
+            return;
+        }
+        FScriptArray NewArray;
+        NewArray.Empty(Capacity, ElementSize);
+        if (Num > 0)
+        {
+            NewArray.Add(Num, ElementSize);
+            FMemory::Memcpy(NewArray.GetData(), ScriptArray->GetData(), Num * ElementSize);
+        }
+        // 交换后旧内存由NewArray析构时释放，FScriptArray不会析构元素
+        FMemory::Memswap(ScriptArray, &NewArray, sizeof(FScriptArray));
+    }
+
     FORCEINLINE void FScriptArrayWrapper::Construct(FScriptArray *ScriptArray, FPropertyTranslator *Inner, int32 Index, int32 Count)
     {
         int32 ElementSize = Inner->Property->GetSize();
@@ -212,6 +972,13 @@ namespace puerts
         auto PropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
         auto Property = PropertyTranslator->Property;
 
+        // TArray没有索引，仍然是线性查找，只是省掉逐个元素的Identical虚调用
+        EFastKey FastKey = GetFastKey(Property);
+        if (FastKey != EFastKey::None)
+        {
+            return DispatchFastKey<TFindInArray>(FastKey, Isolate, Context, Info[0], PropertyTranslator, Self);
+        }
+
         void* Dest = FMemory_Alloca(Property->GetSize());
         Property->InitializeValue(Dest);
         PropertyTranslator->JsToUE(Isolate, Context, Info[0], Dest, false);
@@ -231,6 +998,39 @@ namespace puerts
         return Result;
     }
 
+    v8::Local<v8::Array> FScriptArrayWrapper::ToArrayInner(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::EscapableHandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptArray>(Info.Holder(), 0);
+        auto Inner = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+
+        const int32 Num = Self->Num();
+        const int32 ElementSize = Inner->Property->GetSize();
+        auto Result = v8::Array::New(Isolate, Num);
+        for (int32 i = 0; i < Num; ++i)
+        {
+            v8::HandleScope ElementScope(Isolate);
+            // 按值转换，struct、容器元素不引用容器内存，之后修改容器不影响已返回的元素
+            Result->Set(Context, i, Inner->UEToJs(Isolate, Context, GetData(Self, ElementSize, i), false)).Check();
+        }
+        return HandleScope.Escape(Result);
+    }
+
+    void FScriptArrayWrapper::DetachView(v8::Local<v8::Object> Holder)
+    {
+#ifndef WITH_QUICKJS
+        v8::Local<v8::Value> View = Holder->GetInternalField(4);
+        if (View->IsArrayBuffer())
+        {
+            v8::Local<v8::ArrayBuffer>::Cast(View)->Detach();
+            Holder->SetInternalField(4, v8::Undefined(Holder->GetIsolate()));
+        }
+#endif
+    }
+
     //---------------------------------------Set-----------------------------------------------
 
     v8::Local<v8::FunctionTemplate> FScriptSetWrapper::ToFunctionTemplate(v8::Isolate* Isolate)
@@ -249,6 +1049,11 @@ namespace puerts
         Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "GetMaxIndex"), v8::FunctionTemplate::New(Isolate, GetMaxIndex));
         Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "IsValidIndex"), v8::FunctionTemplate::New(Isolate, IsValidIndex));
         Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Empty"), v8::FunctionTemplate::New(Isolate, Empty));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "forEach"), v8::FunctionTemplate::New(Isolate, ForEach));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "toArray"), v8::FunctionTemplate::New(Isolate, ToArray));
+#ifndef WITH_QUICKJS
+        Result->PrototypeTemplate()->Set(v8::Symbol::GetIterator(Isolate), v8::FunctionTemplate::New(Isolate, Iterator));
+#endif
 
         return HandleScope.Escape(Result);
     }
@@ -388,6 +1193,81 @@ namespace puerts
         Self->Empty(0, ScriptLayout);
     }
 
+    void FScriptSetWrapper::ForEach(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        CHECK_V8_ARGS_LEN(1);
+
+        if (!Info[0]->IsFunction())
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #0, expect a function");
+            return;
+        }
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptSet>(Info.Holder(), 0);
+        auto PropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+        auto Property = PropertyTranslator->Property;
+        auto Callback = v8::Local<v8::Function>::Cast(Info[0]);
+
+        auto ScriptLayout = FScriptSet::GetScriptLayout(Property->GetSize(), Property->GetMinAlignment());
+        for (int32 i = 0; i < Self->GetMaxIndex(); ++i)
+        {
+            if (Self->IsValidIndex(i))
+            {
+                v8::HandleScope ElementScope(Isolate);
+                v8::Local<v8::Value> Args[] = { PropertyTranslator->UEToJs(Isolate, Context, Self->GetData(i, ScriptLayout), true) };
+                if (Callback->Call(Context, v8::Undefined(Isolate), 1, Args).IsEmpty())
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    void FScriptSetWrapper::ToArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+
+        Info.GetReturnValue().Set(ToArrayInner(Info));
+    }
+
+    void FScriptSetWrapper::Iterator(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        ReturnArrayIterator(Info, Context, ToArrayInner(Info));
+    }
+
+    v8::Local<v8::Array> FScriptSetWrapper::ToArrayInner(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::EscapableHandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptSet>(Info.Holder(), 0);
+        auto PropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+        auto Property = PropertyTranslator->Property;
+
+        auto ScriptLayout = FScriptSet::GetScriptLayout(Property->GetSize(), Property->GetMinAlignment());
+        auto Result = v8::Array::New(Isolate, Self->Num());
+        const int32 MaxIndex = Self->GetMaxIndex();
+        for (int32 i = 0, j = 0; i < MaxIndex; ++i)
+        {
+            if (Self->IsValidIndex(i))
+            {
+                v8::HandleScope ElementScope(Isolate);
+                Result->Set(Context, j++, PropertyTranslator->UEToJs(Isolate, Context, Self->GetData(i, ScriptLayout), false)).Check();
+            }
+        }
+        return HandleScope.Escape(Result);
+    }
+
     void FScriptSetWrapper::Destruct(FScriptSet *ScriptSet, FPropertyTranslator *Inner, int32 Index, int32 Count)
     {
         int32 MaxIndex = ScriptSet->GetMaxIndex();
@@ -413,13 +1293,19 @@ namespace puerts
         auto PropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
         auto Property = PropertyTranslator->Property;
 
+        auto ScriptLayout = FScriptSet::GetScriptLayout(Property->GetSize(), Property->GetMinAlignment());
+
+        EFastKey FastKey = GetFastKey(Property);
+        if (FastKey != EFastKey::None)
+        {
+            return DispatchFastKey<TFindInSet>(FastKey, Isolate, Context, Info[0], PropertyTranslator, Self, ScriptLayout);
+        }
+
         void* DataPtr = FMemory_Alloca(Property->GetSize());
         Property->InitializeValue(DataPtr);
 
         PropertyTranslator->JsToUE(Isolate, Context, Info[0], DataPtr, false);
 
-        auto ScriptLayout = FScriptSet::GetScriptLayout(Property->GetSize(), Property->GetMinAlignment());
-
         int32 Result = Self->FindIndex(DataPtr, ScriptLayout,
             [Property](const void* Element) { return Property->GetValueTypeHash(Element); },
             [Property](const void* A, const void* B) { return Property->Identical(A, B); }
@@ -445,6 +1331,12 @@ namespace puerts
         Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "IsValidIndex"), v8::FunctionTemplate::New(Isolate, IsValidIndex));
         Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "GetKey"), v8::FunctionTemplate::New(Isolate, GetKey));
         Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "Empty"), v8::FunctionTemplate::New(Isolate, Empty));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "forEach"), v8::FunctionTemplate::New(Isolate, ForEach));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "toArray"), v8::FunctionTemplate::New(Isolate, ToArray));
+        Result->PrototypeTemplate()->Set(FV8Utils::InternalString(Isolate, "toJSMap"), v8::FunctionTemplate::New(Isolate, ToJSMap));
+#ifndef WITH_QUICKJS
+        Result->PrototypeTemplate()->Set(v8::Symbol::GetIterator(Isolate), v8::FunctionTemplate::New(Isolate, Iterator));
+#endif
 
         return HandleScope.Escape(Result);
     }
@@ -518,22 +1410,14 @@ namespace puerts
         auto ValuePropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 2);
         auto ValueProperty = ValuePropertyTranslator->Property;
 
-        void* KeyPtr = FMemory_Alloca(KeyProperty->GetSize());
-        KeyProperty->InitializeValue(KeyPtr);
-        KeyPropertyTranslator->JsToUE(Isolate, Context, Info[0], KeyPtr, false);
-        
-        auto ScriptLayout = FScriptMap::GetScriptLayout(KeyProperty->GetSize(), KeyProperty->GetMinAlignment(), ValueProperty->GetSize(), ValueProperty->GetMinAlignment());
-
-        void* ValuePtr = Self->FindValue(KeyPtr, ScriptLayout,
-            [KeyProperty](const void* ElementKey) { return KeyProperty->GetValueTypeHash(ElementKey); },
-            [KeyProperty](const void* A, const void* B) { return KeyProperty->Identical(A, B); }
-        );
+        auto ScriptLayout = GetScriptLayout(KeyProperty, ValueProperty);
+        int32 Index = FindPairIndexInner(Isolate, Context, Info[0], Self, KeyPropertyTranslator, ScriptLayout);
 
-        if (ValuePtr)
+        if (Index != INDEX_NONE)
         {
+            uint8* ValuePtr = reinterpret_cast<uint8*>(Self->GetData(Index, ScriptLayout)) + ScriptLayout.ValueOffset;
             Info.GetReturnValue().Set(ValuePropertyTranslator->UEToJs(Isolate, Context, ValuePtr, true));
         }
-        KeyProperty->DestroyValue(KeyPtr);
     }
 
     void FScriptMapWrapper::Set(const v8::FunctionCallbackInfo<v8::Value>& Info)
@@ -555,15 +1439,8 @@ namespace puerts
         auto ValuePropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 2);
         auto ValueProperty = ValuePropertyTranslator->Property;
 
-        void* KeyPtr = FMemory_Alloca(KeyProperty->GetSize());
-        KeyProperty->InitializeValue(KeyPtr);
-        KeyPropertyTranslator->JsToUE(Isolate, Context, Info[0], KeyPtr, false);
-
         auto ScriptLayout = GetScriptLayout(KeyProperty, ValueProperty);
-        int32 Index = Self->FindPairIndex(KeyPtr, ScriptLayout,
-            [KeyProperty](const void* Key) { return KeyProperty->GetValueTypeHash(Key); },
-            [KeyProperty](const void* A, const void* B) { return KeyProperty->Identical(A, B); }
-        );
+        int32 Index = FindPairIndexInner(Isolate, Context, Info[0], Self, KeyPropertyTranslator, ScriptLayout);
         if (Index == INDEX_NONE)
         {
             FV8Utils::ThrowException(Isolate, TEXT("invalid key argument"));
@@ -573,7 +1450,6 @@ namespace puerts
             Destruct(Self, KeyPropertyTranslator, ValuePropertyTranslator, Index, 1);
             Self->RemoveAt(Index, ScriptLayout);
         }
-        KeyProperty->DestroyValue(KeyPtr);
     }
 
     void FScriptMapWrapper::GetMaxIndex(const v8::FunctionCallbackInfo<v8::Value>& Info)
@@ -644,6 +1520,120 @@ namespace puerts
         Self->Empty(0, ScriptLayout);
     }
 
+    void FScriptMapWrapper::ForEach(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        CHECK_V8_ARGS_LEN(1);
+
+        if (!Info[0]->IsFunction())
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #0, expect a function");
+            return;
+        }
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptMap>(Info.Holder(), 0);
+        auto KeyPropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+        auto ValuePropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 2);
+        auto Callback = v8::Local<v8::Function>::Cast(Info[0]);
+
+        auto ScriptLayout = GetScriptLayout(KeyPropertyTranslator->Property, ValuePropertyTranslator->Property);
+        for (int32 i = 0; i < Self->GetMaxIndex(); ++i)
+        {
+            if (Self->IsValidIndex(i))
+            {
+                v8::HandleScope ElementScope(Isolate);
+                uint8* Data = reinterpret_cast<uint8*>(Self->GetData(i, ScriptLayout));
+                v8::Local<v8::Value> Args[] = {
+                    ValuePropertyTranslator->UEToJs(Isolate, Context, Data + ScriptLayout.ValueOffset, true),
+                    KeyPropertyTranslator->UEToJs(Isolate, Context, Data + GetKeyOffset(ScriptLayout), true)
+                };
+                if (Callback->Call(Context, v8::Undefined(Isolate), 2, Args).IsEmpty())
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    void FScriptMapWrapper::ToArray(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+
+        Info.GetReturnValue().Set(ToArrayInner(Info));
+    }
+
+    void FScriptMapWrapper::ToJSMap(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+#ifndef WITH_QUICKJS
+        auto Self = FV8Utils::GetPoninterFast<FScriptMap>(Info.Holder(), 0);
+        auto KeyPropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+        auto ValuePropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 2);
+
+        auto ScriptLayout = GetScriptLayout(KeyPropertyTranslator->Property, ValuePropertyTranslator->Property);
+        auto Result = v8::Map::New(Isolate);
+        const int32 MaxIndex = Self->GetMaxIndex();
+        for (int32 i = 0; i < MaxIndex; ++i)
+        {
+            if (Self->IsValidIndex(i))
+            {
+                v8::HandleScope ElementScope(Isolate);
+                uint8* Data = reinterpret_cast<uint8*>(Self->GetData(i, ScriptLayout));
+                Result->Set(Context,
+                    KeyPropertyTranslator->UEToJs(Isolate, Context, Data + GetKeyOffset(ScriptLayout), false),
+                    ValuePropertyTranslator->UEToJs(Isolate, Context, Data + ScriptLayout.ValueOffset, false)).ToLocalChecked();
+            }
+        }
+        Info.GetReturnValue().Set(Result);
+#else
+        FV8Utils::ThrowException(Isolate, "toJSMap no support yet");
+#endif
+    }
+
+    void FScriptMapWrapper::Iterator(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        ReturnArrayIterator(Info, Context, ToArrayInner(Info));
+    }
+
+    v8::Local<v8::Array> FScriptMapWrapper::ToArrayInner(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::EscapableHandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+
+        auto Self = FV8Utils::GetPoninterFast<FScriptMap>(Info.Holder(), 0);
+        auto KeyPropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
+        auto ValuePropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 2);
+
+        auto ScriptLayout = GetScriptLayout(KeyPropertyTranslator->Property, ValuePropertyTranslator->Property);
+        auto Result = v8::Array::New(Isolate, Self->Num());
+        const int32 MaxIndex = Self->GetMaxIndex();
+        for (int32 i = 0, j = 0; i < MaxIndex; ++i)
+        {
+            if (Self->IsValidIndex(i))
+            {
+                v8::HandleScope ElementScope(Isolate);
+                uint8* Data = reinterpret_cast<uint8*>(Self->GetData(i, ScriptLayout));
+                auto Entry = v8::Array::New(Isolate, 2);
+                Entry->Set(Context, 0, KeyPropertyTranslator->UEToJs(Isolate, Context, Data + GetKeyOffset(ScriptLayout), false)).Check();
+                Entry->Set(Context, 1, ValuePropertyTranslator->UEToJs(Isolate, Context, Data + ScriptLayout.ValueOffset, false)).Check();
+                Result->Set(Context, j++, Entry).Check();
+            }
+        }
+        return HandleScope.Escape(Result);
+    }
+
     void FScriptMapWrapper::Destruct(FScriptMap *ScriptMap, FPropertyTranslator *KeyTranslator, FPropertyTranslator *ValueTranslator, int32 Index, int32 Count)
     {
         int32 MaxIndex = ScriptMap->GetMaxIndex();
@@ -663,6 +1653,28 @@ namespace puerts
         }
     }
 
+    int32 FScriptMapWrapper::FindPairIndexInner(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, v8::Local<v8::Value> Key, FScriptMap *ScriptMap, FPropertyTranslator *KeyTranslator, const FScriptMapLayout& ScriptLayout)
+    {
+        auto KeyProperty = KeyTranslator->Property;
+
+        EFastKey FastKey = GetFastKey(KeyProperty);
+        if (FastKey != EFastKey::None)
+        {
+            return DispatchFastKey<TFindInMap>(FastKey, Isolate, Context, Key, KeyTranslator, ScriptMap, ScriptLayout);
+        }
+
+        void* KeyPtr = FMemory_Alloca(KeyProperty->GetSize());
+        KeyProperty->InitializeValue(KeyPtr);
+        KeyTranslator->JsToUE(Isolate, Context, Key, KeyPtr, false);
+
+        int32 Index = ScriptMap->FindPairIndex(KeyPtr, ScriptLayout,
+            [KeyProperty](const void* ElementKey) { return KeyProperty->GetValueTypeHash(ElementKey); },
+            [KeyProperty](const void* A, const void* B) { return KeyProperty->Identical(A, B); }
+        );
+        KeyProperty->DestroyValue(KeyPtr);
+        return Index;
+    }
+
     FScriptMapLayout FScriptMapWrapper::GetScriptLayout(const PropertyMacro* KeyProperty, const PropertyMacro* ValueProperty)
     {
         return FScriptMap::GetScriptLayout(KeyProperty->GetSize(), KeyProperty->GetMinAlignment(), ValueProperty->GetSize(), ValueProperty->GetMinAlignment());
@@ -701,6 +1713,12 @@ namespace puerts
         v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
 
         auto Self = FV8Utils::GetPoninterFast<uint8>(Info.Holder(), 0);
+        if (!Self)
+        {
+            // frameScope结束后，帧struct里的定长数组会被置空
+            FV8Utils::ThrowException(Isolate, "access a released array");
+            return;
+        }
         auto PropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
         auto Property = PropertyTranslator->Property;
 
@@ -729,6 +1747,11 @@ namespace puerts
         v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
 
         auto Self = FV8Utils::GetPoninterFast<uint8>(Info.Holder(), 0);
+        if (!Self)
+        {
+            FV8Utils::ThrowException(Isolate, "access a released array");
+            return;
+        }
         auto PropertyTranslator = FV8Utils::GetPoninterFast<FPropertyTranslator>(Info.Holder(), 1);
         auto Property = PropertyTranslator->Property;
 
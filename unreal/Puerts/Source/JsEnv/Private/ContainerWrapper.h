@@ -29,17 +29,9 @@ template<typename T>
 class FContinerWrapper
 {
 public:
-    static void OnGarbageCollectedWithFree(const v8::WeakCallbackInfo<void>& Data)
+    static void OnGarbageCollectedWithFree(void* Ptr)
     {
-        T *Container = static_cast<T*>(DataTransfer::MakeAddressWithHighPartOfTwo(Data.GetInternalField(0), Data.GetInternalField(1)));
-        FV8Utils::IsolateData<IObjectMapper>(Data.GetIsolate())->UnBindContainer(Container);
-        delete Container;
-    }
-
-    static void OnGarbageCollected(const v8::WeakCallbackInfo<void>& Data)
-    {
-        T *Container = static_cast<T*>(DataTransfer::MakeAddressWithHighPartOfTwo(Data.GetInternalField(0), Data.GetInternalField(1)));
-        FV8Utils::IsolateData<IObjectMapper>(Data.GetIsolate())->UnBindContainer(Container);
+        delete static_cast<T*>(Ptr);
     }
 
     static void New(const v8::FunctionCallbackInfo<v8::Value>& Info)
@@ -56,7 +48,7 @@ public:
             bool PassByPointer = Info[1]->BooleanValue(Isolate);
             if (PassByPointer)
             {
-                FV8Utils::IsolateData<IObjectMapper>(Isolate)->BindContainer(Ptr, Self, OnGarbageCollected);
+                FV8Utils::IsolateData<IObjectMapper>(Isolate)->BindContainer(Ptr, Self, nullptr);
             }
             else
             {
@@ -89,6 +81,9 @@ class FScriptArrayWrapper : public FContinerWrapper<FScriptArray>
 public:
     static v8::Local<v8::FunctionTemplate> ToFunctionTemplate(v8::Isolate* Isolate);
 
+    // 在基类基础上记录容器内存是否归js对象所有（按值传到js），asTypedArrayView只支持这种
+    static void New(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
 private:
     // 参数：一到多个容器元素
     // 返回：无
@@ -129,17 +124,80 @@ private:
     // 返回：无
     // 作用：清空容器
     static void Empty(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：无
+    // 返回：TypedArray
+    // 作用：把数值类型（或者只由同一种数值字段组成的结构体，比如FVector）的数组整块拷贝成TypedArray，其它元素类型抛异常
+    static void ToTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：无
+    // 返回：TypedArray
+    // 作用：同toTypedArray，但不拷贝，直接引用容器内存；通过该容器对象改变长度（Add、RemoveAt、Empty等）后视图会被detach（长度变为0）
+    //       只支持按值传到js的数组（内存归该容器对象所有，C++侧拿不到），传指针的数组（比如obj.Arr）所有者销毁或者C++侧修改都会让视图指向已释放的内存，直接抛异常，请用toTypedArray
+    static void AsTypedArrayView(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：元素类型对应的TypedArray
+    // 返回：无
+    // 作用：按TypedArray的长度重设容器长度并整块拷贝
+    static void SetFromTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：回调函数(元素, 索引)
+    // 返回：无
+    // 作用：按顺序对每个元素调用回调；和Get一样，struct、容器元素直接引用容器内存，回调里改变容器长度后不能再用之前的元素
+    static void ForEach(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：无
+    // 返回：js数组
+    // 作用：一次性把所有元素按值拷贝成js数组，之后修改容器不影响返回的数组
+    static void ToArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：无
+    // 返回：迭代器
+    // 作用：用于for...of，遍历的是调用时按值拷贝的快照，循环体里可以修改容器
+    static void Iterator(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：元素个数
+    // 返回：无
+    // 作用：预留容量，之后添加不超过该数量的元素不会重新分配内存
+    static void Reserve(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：同类型的TArray或者js数组
+    // 返回：无
+    // 作用：把参数中的所有元素追加到容器末尾，只分配一次内存
+    static void Append(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：元素个数
+    // 返回：无
+    // 作用：设置容器长度，新增元素为默认值，多余元素被移除
+    static void SetNum(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：无
+    // 返回：无
+    // 作用：释放多余的预留空间
+    static void Shrink(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 参数：比较函数(a, b)，返回负数表示a排在b前面；元素为数值、FName、FString时可省略，按元素类型的<排序，浮点数的NaN排在最后
+    // 返回：无
+    // 作用：稳定排序
+    static void Sort(const v8::FunctionCallbackInfo<v8::Value>& Info);
     
 private:
     FORCEINLINE static int32 AddUninitialized(FScriptArray *ScriptArray, int32 ElementSize, int32 Count = 1);
 
     FORCEINLINE static uint8* GetData(FScriptArray *ScriptArray, int32 ElementSize, int32 Index);
 
+    static void ReserveCapacity(FScriptArray *ScriptArray, int32 ElementSize, int32 Capacity);
+
     FORCEINLINE static void Construct(FScriptArray *ScriptArray, FPropertyTranslator *Inner, int32 Index, int32 Count = 1);
 
     FORCEINLINE static void Destruct(FScriptArray *ScriptArray, FPropertyTranslator *Inner, int32 Index, int32 Count = 1);
 
     static int32 FindIndexInner(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    static v8::Local<v8::Array> ToArrayInner(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 容器长度变化可能导致内存重新分配，之前asTypedArrayView返回的视图要失效
+    static void DetachView(v8::Local<v8::Object> Holder);
 };
 
 class FScriptSetWrapper : public FContinerWrapper<FScriptSet>
@@ -163,7 +221,15 @@ private:
 
     static void Empty(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
+    static void ForEach(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    static void ToArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    static void Iterator(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
 private:
+    static v8::Local<v8::Array> ToArrayInner(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
     FORCEINLINE static void Destruct(FScriptSet *ScriptSet, FPropertyTranslator *Inner, int32 Index, int32 Count = 1);
 
     FORCEINLINE static int32 FindIndexInner(const v8::FunctionCallbackInfo<v8::Value>& Info);
@@ -191,9 +257,23 @@ private:
 
     static void Empty(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
+    // 回调参数为(值, 键)，和js的Map.prototype.forEach一致
+    static void ForEach(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    // 返回[键, 值]数组，和toJSMap、for...of一样是按值拷贝的快照
+    static void ToArray(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    static void ToJSMap(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    static void Iterator(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
 private:
+    static v8::Local<v8::Array> ToArrayInner(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
     FORCEINLINE static void Destruct(FScriptMap *ScriptMap, FPropertyTranslator *KeyTranslator, FPropertyTranslator *ValueTranslator, int32 Index, int32 Count = 1);
 
+    static int32 FindPairIndexInner(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, v8::Local<v8::Value> Key, FScriptMap *ScriptMap, FPropertyTranslator *KeyTranslator, const FScriptMapLayout& ScriptLayout);
+
     FORCEINLINE static FScriptMapLayout GetScriptLayout(const PropertyMacro* KeyProperty, const PropertyMacro* ValueProperty);
 };
 
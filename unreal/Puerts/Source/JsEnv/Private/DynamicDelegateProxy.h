@@ -39,4 +39,7 @@ public:
     TWeakObjectPtr<UObject> Owner;
 
     v8::UniquePersistent<v8::Function> JsFunction;
+
+    // 在FJsEnvImpl::DelegateProxys中的下标，释放后为INDEX_NONE
+    int32 ProxyIndex = INDEX_NONE;
 };
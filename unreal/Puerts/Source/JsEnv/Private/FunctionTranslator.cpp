@@ -7,6 +7,8 @@
 
 #include "FunctionTranslator.h"
 #include "V8Utils.h"
+#include "ParamsBufferArena.h"
+#include "ObjectMapper.h"
 #include "Misc/DefaultValueHelper.h"
 
 static TMap<FName, TMap<FName, TMap<FName, FString>>> ParamDefaultMetas;
@@ -44,35 +46,33 @@ namespace puerts
 {
 static const int ARG_ARRAY_SIZE = 8;
 
-#if defined(USE_GLOBAL_PARAMS_BUFFER)
-//Global Buffer, Not thread safe
-static void *Buffer = nullptr;
-static int BufferSize = 0;
-
-
-static void RequireBuffer(int RequireSize)
+// 回调进js时参数和回调内的调用一律用包装对象，mathStructTypedArrayScope只对scope内直接发起的调用生效
+class FMathStructTypedArrayModeGuard
 {
-    if (RequireSize > BufferSize)
+public:
+    explicit FMathStructTypedArrayModeGuard(v8::Isolate* Isolate) : ObjectMapper(FV8Utils::IsolateData<IObjectMapper>(Isolate))
     {
-        if (Buffer)  FMemory::Free(Buffer);
-        Buffer = FMemory::Malloc(RequireSize, 16);
-        BufferSize = RequireSize;
+        Mode = ObjectMapper->GetMathStructTypedArrayMode();
+        if (Mode != 0)
+        {
+            ObjectMapper->SetMathStructTypedArrayMode(0);
+        }
     }
-}
 
-class GlobalBufferAutoRelease
-{
-public:
-    ~GlobalBufferAutoRelease()
+    ~FMathStructTypedArrayModeGuard()
     {
-        if (Buffer)  FMemory::Free(Buffer);
-        Buffer = nullptr;
-        BufferSize = 0;
+        if (Mode != 0)
+        {
+            ObjectMapper->SetMathStructTypedArrayMode(Mode);
+        }
     }
+
+private:
+    IObjectMapper* ObjectMapper;
+
+    int32 Mode;
 };
 
-static GlobalBufferAutoRelease Dummy;
-#endif
 
 FFunctionTranslator::FFunctionTranslator(UFunction *InFunction)
 {
@@ -81,14 +81,22 @@ FFunctionTranslator::FFunctionTranslator(UFunction *InFunction)
 
     ParamsBufferSize = InFunction->PropertiesSize > InFunction->ParmsSize ? InFunction->PropertiesSize : InFunction->ParmsSize;
 
-#if defined(USE_GLOBAL_PARAMS_BUFFER)
-    RequireBuffer(ParamsBufferSize);
-#endif
-
     UClass *OuterClass = InFunction->GetOuterUClass();
     IsInterfaceFunction = (OuterClass->HasAnyClassFlags(CLASS_Interface) && OuterClass != UInterface::StaticClass());
     BindObject = InFunction->HasAnyFunctionFlags(FUNC_Static) ? OuterClass->GetDefaultObject() : nullptr;
 
+    for (int i = 0; i < INTERFACE_CACHE_SIZE; ++i)
+    {
+        InterfaceCache[i].Class = nullptr;
+    }
+    InterfaceCacheGeneration = GlobalInterfaceCacheGeneration;
+
+#if !defined(WITHOUT_DIRECT_NATIVE_CALL)
+    // 网络相关、BlueprintAuthorityOnly/BlueprintCosmetic（都需要GetFunctionCallspace判断）以及蓝图事件（可能被蓝图覆盖）依然走ProcessEvent
+    CanCallNativeDirectly = !IsInterfaceFunction && InFunction->HasAnyFunctionFlags(FUNC_Native) && InFunction->GetNativeFunc() != nullptr
+        && !InFunction->HasAnyFunctionFlags(FUNC_Net | FUNC_NetReliable | FUNC_NetRequest | FUNC_NetResponse | FUNC_NetMulticast | FUNC_NetServer | FUNC_NetClient | FUNC_BlueprintAuthorityOnly | FUNC_BlueprintCosmetic | FUNC_BlueprintEvent | FUNC_Event);
+#endif
+
     for (TFieldIterator<PropertyMacro> It(InFunction); It && (It->PropertyFlags & CPF_Parm); ++It)
     {
         PropertyMacro *Property = *It;
@@ -102,6 +110,10 @@ FFunctionTranslator::FFunctionTranslator(UFunction *InFunction)
         }
     }
 
+#if defined(USE_FAST_CALL)
+    BuildFastCallPlan();
+#endif
+
     ArgumentDefaultValues = nullptr;
 
     TMap<FName, FString> *MetaMap = GetParamDefaultMetaFor(InFunction);
@@ -170,6 +182,299 @@ FFunctionTranslator::FFunctionTranslator(UFunction *InFunction)
     }
 }
 
+#if defined(USE_FAST_CALL)
+FFunctionTranslator::EFastArgKind FFunctionTranslator::GetFastArgKind(PropertyMacro *Property)
+{
+    if (Property->ArrayDim != 1)
+    {
+        return EFastArgKind::Generic;
+    }
+    if (Property->IsA<Int8PropertyMacro>())
+    {
+        return EFastArgKind::Int8;
+    }
+    else if (Property->IsA<BytePropertyMacro>())
+    {
+        return EFastArgKind::UInt8;
+    }
+    else if (Property->IsA<Int16PropertyMacro>())
+    {
+        return EFastArgKind::Int16;
+    }
+    else if (Property->IsA<UInt16PropertyMacro>())
+    {
+        return EFastArgKind::UInt16;
+    }
+    else if (Property->IsA<IntPropertyMacro>())
+    {
+        return EFastArgKind::Int32;
+    }
+    else if (Property->IsA<UInt32PropertyMacro>())
+    {
+        return EFastArgKind::UInt32;
+    }
+    else if (Property->IsA<FloatPropertyMacro>())
+    {
+        return EFastArgKind::Float;
+    }
+    else if (Property->IsA<DoublePropertyMacro>())
+    {
+        return EFastArgKind::Double;
+    }
+    else if (const BoolPropertyMacro *BoolProperty = CastFieldMacro<BoolPropertyMacro>(Property))
+    {
+        if (BoolProperty->IsNativeBool())
+        {
+            return EFastArgKind::Bool;
+        }
+    }
+    return EFastArgKind::Generic;
+}
+
+void FFunctionTranslator::BuildFastCallPlan()
+{
+    FastCallEnable = false;
+    ParamsIsPOD = true;
+    HasOutParams = false;
+    FastReturn.Kind = EFastArgKind::Generic;
+    FastReturn.Offset = 0;
+
+    // 接口函数实际调用的是实现类的UFunction，参数布局以外的部分（比如局部变量）可能不一致，不走快速路径
+    if (IsInterfaceFunction)
+    {
+        return;
+    }
+
+    for (TFieldIterator<PropertyMacro> It(Function); It; ++It)
+    {
+        if (!It->HasAllPropertyFlags(CPF_ZeroConstructor | CPF_NoDestructor))
+        {
+            ParamsIsPOD = false;
+            break;
+        }
+    }
+
+    int ArgIndex = 0;
+    for (TFieldIterator<PropertyMacro> It(Function); It && (It->PropertyFlags & CPF_Parm); ++It)
+    {
+        PropertyMacro *Property = *It;
+        FFastArg FastArg;
+        FastArg.Kind = GetFastArgKind(Property);
+        FastArg.Offset = Property->GetOffset_ForInternal();
+        if (Property->HasAnyPropertyFlags(CPF_ReturnParm))
+        {
+            FastReturn = FastArg;
+        }
+        else
+        {
+            if (Arguments[ArgIndex]->IsOut())
+            {
+                // 传入的是$ref包装对象，交给FOutReflection处理
+                FastArg.Kind = EFastArgKind::Generic;
+                HasOutParams = true;
+            }
+            FastArgs.push_back(FastArg);
+            ++ArgIndex;
+        }
+    }
+
+    FastCallEnable = ParamsIsPOD;
+}
+
+void FFunctionTranslator::FastCall(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::FunctionCallbackInfo<v8::Value>& Info, UObject *CallObject)
+{
+    FParamsBufferScope ParamsBufferScope(ParamsBufferSize);
+    uint8 *Params = static_cast<uint8*>(ParamsBufferScope.GetBuffer());
+
+    if (Params) FMemory::Memzero(Params, ParamsBufferSize);
+
+    for (int i = 0; i < FastArgs.size(); ++i)
+    {
+        v8::Local<v8::Value> Value = Info[i];
+        if (UNLIKELY(ArgumentDefaultValues && Value->IsUndefined()))
+        {
+            Arguments[i]->Property->CopyCompleteValue_InContainer(Params, ArgumentDefaultValues);
+            continue;
+        }
+        uint8 *ValuePtr = Params + FastArgs[i].Offset;
+        switch (FastArgs[i].Kind)
+        {
+        case EFastArgKind::Int8:
+            *reinterpret_cast<int8*>(ValuePtr) = static_cast<int8>(Value->Int32Value(Context).ToChecked());
+            break;
+        case EFastArgKind::UInt8:
+            *reinterpret_cast<uint8*>(ValuePtr) = static_cast<uint8>(Value->Int32Value(Context).ToChecked());
+            break;
+        case EFastArgKind::Int16:
+            *reinterpret_cast<int16*>(ValuePtr) = static_cast<int16>(Value->Int32Value(Context).ToChecked());
+            break;
+        case EFastArgKind::UInt16:
+            *reinterpret_cast<uint16*>(ValuePtr) = static_cast<uint16>(Value->Int32Value(Context).ToChecked());
+            break;
+        case EFastArgKind::Int32:
+            *reinterpret_cast<int32*>(ValuePtr) = Value->Int32Value(Context).ToChecked();
+            break;
+        case EFastArgKind::UInt32:
+            *reinterpret_cast<uint32*>(ValuePtr) = Value->Uint32Value(Context).ToChecked();
+            break;
+        case EFastArgKind::Float:
+            *reinterpret_cast<float*>(ValuePtr) = static_cast<float>(Value->NumberValue(Context).ToChecked());
+            break;
+        case EFastArgKind::Double:
+            *reinterpret_cast<double*>(ValuePtr) = Value->NumberValue(Context).ToChecked();
+            break;
+        case EFastArgKind::Bool:
+            *reinterpret_cast<bool*>(ValuePtr) = Value->BooleanValue(Isolate);
+            break;
+        default:
+            if (!Arguments[i]->JsToUEInContainer(Isolate, Context, Value, Params, false))
+            {
+                return;
+            }
+        }
+    }
+
+    ProcessEvent(CallObject, Function, Params);
+
+    if (Return)
+    {
+        uint8 *ReturnPtr = Params + FastReturn.Offset;
+        switch (FastReturn.Kind)
+        {
+        case EFastArgKind::Int8:
+            Info.GetReturnValue().Set(static_cast<int32>(*reinterpret_cast<int8*>(ReturnPtr)));
+            break;
+        case EFastArgKind::UInt8:
+            Info.GetReturnValue().Set(static_cast<int32>(*reinterpret_cast<uint8*>(ReturnPtr)));
+            break;
+        case EFastArgKind::Int16:
+            Info.GetReturnValue().Set(static_cast<int32>(*reinterpret_cast<int16*>(ReturnPtr)));
+            break;
+        case EFastArgKind::UInt16:
+            Info.GetReturnValue().Set(static_cast<int32>(*reinterpret_cast<uint16*>(ReturnPtr)));
+            break;
+        case EFastArgKind::Int32:
+            Info.GetReturnValue().Set(*reinterpret_cast<int32*>(ReturnPtr));
+            break;
+        case EFastArgKind::UInt32:
+            Info.GetReturnValue().Set(*reinterpret_cast<uint32*>(ReturnPtr));
+            break;
+        case EFastArgKind::Float:
+            Info.GetReturnValue().Set(static_cast<double>(*reinterpret_cast<float*>(ReturnPtr)));
+            break;
+        case EFastArgKind::Double:
+            Info.GetReturnValue().Set(*reinterpret_cast<double*>(ReturnPtr));
+            break;
+        case EFastArgKind::Bool:
+            Info.GetReturnValue().Set(*reinterpret_cast<bool*>(ReturnPtr));
+            break;
+        default:
+            Info.GetReturnValue().Set(Return->UEToJsInContainer(Isolate, Context, Params));
+        }
+    }
+
+    if (HasOutParams)
+    {
+        for (int i = 0; i < Arguments.size(); ++i)
+        {
+            Arguments[i]->UEOutToJsInContainer(Isolate, Context, Info[i], Params, false);
+        }
+    }
+}
+#endif
+
+uint32 FFunctionTranslator::GlobalInterfaceCacheGeneration = 0;
+
+void FFunctionTranslator::InvalidateInterfaceCache()
+{
+    ++GlobalInterfaceCacheGeneration;
+}
+
+UFunction *FFunctionTranslator::ResolveInterfaceFunction(UObject *CallObject)
+{
+    UClass *Class = CallObject->GetClass();
+
+    if (UNLIKELY(InterfaceCacheGeneration != GlobalInterfaceCacheGeneration))
+    {
+        for (int i = 0; i < INTERFACE_CACHE_SIZE; ++i)
+        {
+            InterfaceCache[i].Class = nullptr;
+            InterfaceCache[i].Function.Reset();
+        }
+        InterfaceCacheGeneration = GlobalInterfaceCacheGeneration;
+    }
+
+    int Found = INTERFACE_CACHE_SIZE - 1;
+    UFunction *Result = nullptr;
+    for (int i = 0; i < INTERFACE_CACHE_SIZE; ++i)
+    {
+        if (InterfaceCache[i].Class == Class)
+        {
+            Result = InterfaceCache[i].Function.Get();
+            if (LIKELY(Result))
+            {
+                if (i == 0)
+                {
+                    return Result;
+                }
+            }
+            Found = i;
+            break;
+        }
+    }
+
+    if (!Result)
+    {
+        Result = Class->FindFunctionByName(Function->GetFName());
+        if (!Result)
+        {
+            return nullptr;
+        }
+    }
+
+    // 最近使用的放到最前面
+    for (int i = Found; i > 0; --i)
+    {
+        InterfaceCache[i] = InterfaceCache[i - 1];
+    }
+    InterfaceCache[0].Class = Class;
+    InterfaceCache[0].Function = Result;
+
+    return Result;
+}
+
+#if !defined(WITHOUT_DIRECT_NATIVE_CALL)
+// 和UObject::ProcessEvent对Native函数的处理一致，只是去掉了Callspace判断、统计以及脚本调试等开销
+void FFunctionTranslator::CallNativeDirectly(UObject *CallObject, UFunction *CallFunction, void *Params)
+{
+#if ENGINE_MINOR_VERSION >= 25 || ENGINE_MAJOR_VERSION > 4
+    FFrame NewStack(CallObject, CallFunction, Params, nullptr, CallFunction->ChildProperties);
+#else
+    FFrame NewStack(CallObject, CallFunction, Params, nullptr, CallFunction->Children);
+#endif
+
+    if (CallFunction->HasAnyFunctionFlags(FUNC_HasOutParms))
+    {
+        FOutParmRec** LastOut = &NewStack.OutParms;
+        for (TFieldIterator<PropertyMacro> It(CallFunction); It && (It->PropertyFlags & CPF_Parm); ++It)
+        {
+            if (It->HasAnyPropertyFlags(CPF_OutParm))
+            {
+                FOutParmRec* Out = (FOutParmRec*)FMemory_Alloca(sizeof(FOutParmRec));
+                Out->PropAddr = It->ContainerPtrToValuePtr<uint8>(Params);
+                Out->Property = *It;
+                Out->NextOutParm = nullptr;
+                *LastOut = Out;
+                LastOut = &Out->NextOutParm;
+            }
+        }
+    }
+
+    uint8* ReturnValueAddress = CallFunction->ReturnValueOffset != MAX_uint16 ? static_cast<uint8*>(Params) + CallFunction->ReturnValueOffset : nullptr;
+    CallFunction->Invoke(CallObject, NewStack, ReturnValueAddress);
+}
+#endif
+
 v8::Local<v8::FunctionTemplate> FFunctionTranslator::ToFunctionTemplate(v8::Isolate* Isolate)
 {
     v8::EscapableHandleScope HandleScope(Isolate);
@@ -201,13 +506,16 @@ void FFunctionTranslator::Call(v8::Isolate* Isolate, v8::Local<v8::Context>& Con
         FV8Utils::ThrowException(Isolate, "access a invalid object");
         return;
     }
-    UFunction *CallFunction = !IsInterfaceFunction ? 
-        Function : (CallObject->GetClass()->FindFunctionByName(Function->GetFName()));
-#if defined(USE_GLOBAL_PARAMS_BUFFER)
-    void *Params = Buffer;
-#else
-    void *Params = ParamsBufferSize > 0 ? FMemory_Alloca(ParamsBufferSize) : nullptr;
+#if defined(USE_FAST_CALL)
+    if (FastCallEnable)
+    {
+        FastCall(Isolate, Context, Info, CallObject);
+        return;
+    }
 #endif
+    UFunction *CallFunction = !IsInterfaceFunction ? Function : ResolveInterfaceFunction(CallObject);
+    FParamsBufferScope ParamsBufferScope(ParamsBufferSize);
+    void *Params = ParamsBufferScope.GetBuffer();
 
     if (Params) CallFunction->InitializeStruct(Params);
     for (int i = 0; i < Arguments.size(); ++i)
@@ -222,7 +530,7 @@ void FFunctionTranslator::Call(v8::Isolate* Isolate, v8::Local<v8::Context>& Con
         }
     }
 
-    CallObject->UObject::ProcessEvent(CallFunction, Params);
+    ProcessEvent(CallObject, CallFunction, Params);
 
     if (Return)
     {
@@ -239,11 +547,8 @@ void FFunctionTranslator::Call(v8::Isolate* Isolate, v8::Local<v8::Context>& Con
 
 void FFunctionTranslator::Call(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::FunctionCallbackInfo<v8::Value>& Info, std::function<void(void *)> OnCall)
 {
-#if defined(USE_GLOBAL_PARAMS_BUFFER)
-    void *Params = Buffer;
-#else
-    void *Params = ParamsBufferSize > 0 ? FMemory_Alloca(ParamsBufferSize) : nullptr;
-#endif
+    FParamsBufferScope ParamsBufferScope(ParamsBufferSize);
+    void *Params = ParamsBufferScope.GetBuffer();
 
     if (Params) Function->InitializeStruct(Params);
     for (int i = 0; i < Arguments.size(); ++i)
@@ -269,14 +574,112 @@ void FFunctionTranslator::Call(v8::Isolate* Isolate, v8::Local<v8::Context>& Con
     if (Params) Function->DestroyStruct(Params);
 }
 
+void FFunctionTranslator::BatchCall(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::FunctionCallbackInfo<v8::Value>& Info, v8::Local<v8::Array> Targets, v8::Local<v8::Object> Args, uint32 ArgsLength)
+{
+    const uint32 TargetNum = Targets->Length();
+    const uint32 ArgNum = static_cast<uint32>(Arguments.size());
+    const bool SharedArgs = ArgsLength == ArgNum;
+
+    if (!SharedArgs && ArgsLength != ArgNum * TargetNum)
+    {
+        FV8Utils::ThrowException(Isolate, FString::Printf(TEXT("Bad parameters, %s expect %d arguments for all targets or %d arguments for each of %d targets, but %d provided."),
+            *Function->GetName(), ArgNum, ArgNum, TargetNum, ArgsLength));
+        return;
+    }
+
+    v8::Local<v8::Array> Results;
+    if (Return)
+    {
+        Results = v8::Array::New(Isolate, TargetNum);
+    }
+
+    FParamsBufferScope ParamsBufferScope(ParamsBufferSize);
+    void *Params = ParamsBufferScope.GetBuffer();
+
+    if (Params) Function->InitializeStruct(Params);
+
+    bool Success = true;
+    for (uint32 TargetIndex = 0; TargetIndex < TargetNum; ++TargetIndex)
+    {
+        UObject *CallObject = BindObject ? BindObject : FV8Utils::GetUObject(Context, Targets->Get(Context, TargetIndex).ToLocalChecked());
+        if (!CallObject || FV8Utils::IsReleasedPtr(CallObject))
+        {
+            FV8Utils::ThrowException(Isolate, FString::Printf(TEXT("access a null or invalid object, target #%d"), TargetIndex));
+            Success = false;
+            break;
+        }
+
+        UFunction *CallFunction = Function;
+        if (IsInterfaceFunction)
+        {
+            CallFunction = ResolveInterfaceFunction(CallObject);
+        }
+        else if (!BindObject && !CallObject->IsA(Function->GetOuterUClass()))
+        {
+            CallFunction = nullptr;
+        }
+        if (!CallFunction)
+        {
+            FV8Utils::ThrowException(Isolate, FString::Printf(TEXT("target #%d is a %s, has no function %s"), TargetIndex, *CallObject->GetClass()->GetName(), *Function->GetName()));
+            Success = false;
+            break;
+        }
+
+        // 共用参数只需转换一次，但out/ref参数可能被上一个目标改写，每个目标都要重新转换
+        {
+            const uint32 Base = SharedArgs ? 0 : TargetIndex * ArgNum;
+            const bool ConvertAll = !SharedArgs || TargetIndex == 0;
+            for (uint32 i = 0; i < ArgNum; ++i)
+            {
+                if (!ConvertAll && (!Arguments[i]->Property->HasAnyPropertyFlags(CPF_OutParm) || Arguments[i]->Property->HasAnyPropertyFlags(CPF_ConstParm)))
+                {
+                    continue;
+                }
+                v8::Local<v8::Value> Arg = Args->Get(Context, Base + i).ToLocalChecked();
+                if (UNLIKELY(ArgumentDefaultValues && Arg->IsUndefined()))
+                {
+                    Arguments[i]->Property->CopyCompleteValue_InContainer(Params, ArgumentDefaultValues);
+                }
+                else if (!Arguments[i]->JsToUEInContainer(Isolate, Context, Arg, Params, false))
+                {
+                    Success = false;
+                    break;
+                }
+            }
+            if (!Success)
+            {
+                break;
+            }
+        }
+
+        ProcessEvent(CallObject, CallFunction, Params);
+
+        if (Return)
+        {
+            Results->Set(Context, TargetIndex, Return->UEToJsInContainer(Isolate, Context, Params)).Check();
+        }
+    }
+
+    if (Params) Function->DestroyStruct(Params);
+
+    if (Success && Return)
+    {
+        Info.GetReturnValue().Set(Results);
+    }
+}
+
 void FFunctionTranslator::CallJs(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, v8::Local<v8::Function> JsFunction, v8::Local<v8::Value> This, void *Params)
 {
-    Args.clear();
+    FMathStructTypedArrayModeGuard MathStructTypedArrayModeGuard(Isolate);
+
+    // 放栈上，JsFunction里再次触发同一个UFunction时不会相互覆盖
+    TArray<v8::Local<v8::Value>, TInlineAllocator<ARG_ARRAY_SIZE>> Args;
+    Args.Reserve(Arguments.size());
     for (int i = 0; i < Arguments.size(); ++i)
     {
-        Args.push_back(Arguments[i]->UEToJsInContainer(Isolate, Context, Params, false));
+        Args.Add(Arguments[i]->UEToJsInContainer(Isolate, Context, Params, false));
     }
-    auto Result = JsFunction->Call(Context, This, Args.size(), Args.data());
+    auto Result = JsFunction->Call(Context, This, Args.Num(), Args.GetData());
 
     if (!Result.IsEmpty()) // empty mean exception
     {
@@ -290,7 +693,6 @@ void FFunctionTranslator::CallJs(v8::Isolate* Isolate, v8::Local<v8::Context>& C
             Arguments[i]->JsToUEOutInContainer(Isolate, Context, Args[i], Params, false);
         }
     }
-    Args.clear();
 }
 
 static FOutParmRec* GetMatchOutParmRec(FOutParmRec *OutParam, PropertyMacro *OutProperty)
@@ -312,14 +714,12 @@ void FFunctionTranslator::CallJs(v8::Isolate* Isolate, v8::Local<v8::Context>& C
 {
     void *Params = Stack.Locals;
 
+    FParamsBufferScope ParamsBufferScope(Stack.Node != Stack.CurrentNativeFunction ? ParamsBufferSize : 0);
+
     if (Stack.Node != Stack.CurrentNativeFunction)
     {
-#if defined(USE_GLOBAL_PARAMS_BUFFER)
-        void *Params = Buffer;
-#else
-        Params = ParamsBufferSize > 0 ? FMemory_Alloca(ParamsBufferSize) : nullptr;
-#endif
-            
+        Params = ParamsBufferScope.GetBuffer();
+
         if (Params)
         {
             Function->InitializeStruct(Params);
@@ -336,12 +736,16 @@ void FFunctionTranslator::CallJs(v8::Isolate* Isolate, v8::Local<v8::Context>& C
         Stack.SkipCode(1);          // skip EX_EndFunctionParms
     }
 
-    Args.clear();
+    FMathStructTypedArrayModeGuard MathStructTypedArrayModeGuard(Isolate);
+
+    // 放栈上，JsFunction里再次触发同一个UFunction时不会相互覆盖
+    TArray<v8::Local<v8::Value>, TInlineAllocator<ARG_ARRAY_SIZE>> Args;
+    Args.Reserve(Arguments.size());
     for (int i = 0; i < Arguments.size(); ++i)
     {
-        Args.push_back(Arguments[i]->UEToJsInContainer(Isolate, Context, Params, false));
+        Args.Add(Arguments[i]->UEToJsInContainer(Isolate, Context, Params, false));
     }
-    auto Result = JsFunction->Call(Context, This, Args.size(), Args.data());
+    auto Result = JsFunction->Call(Context, This, Args.Num(), Args.GetData());
 
     if (!Result.IsEmpty()) // empty mean exception
     {
@@ -360,7 +764,6 @@ void FFunctionTranslator::CallJs(v8::Isolate* Isolate, v8::Local<v8::Context>& C
             }
         }
     }
-    Args.clear();
 }
 
 FExtensionMethodTranslator::FExtensionMethodTranslator(UFunction *InFunction) : FFunctionTranslator(InFunction)
@@ -391,11 +794,8 @@ void FExtensionMethodTranslator::CallExtension(const v8::FunctionCallbackInfo<v8
     
 void FExtensionMethodTranslator::CallExtension(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::FunctionCallbackInfo<v8::Value>& Info)
 {
-#if defined(USE_GLOBAL_PARAMS_BUFFER)
-    void *Params = Buffer;
-#else
-    void *Params = ParamsBufferSize > 0 ? FMemory_Alloca(ParamsBufferSize) : nullptr;
-#endif
+    FParamsBufferScope ParamsBufferScope(ParamsBufferSize);
+    void *Params = ParamsBufferScope.GetBuffer();
 
     if (Params) Function->InitializeStruct(Params);
 
@@ -418,7 +818,7 @@ void FExtensionMethodTranslator::CallExtension(v8::Isolate* Isolate, v8::Local<v
         }
     }
 
-    BindObject->UObject::ProcessEvent(Function, Params);
+    ProcessEvent(BindObject, Function, Params);
 
     if (Return)
     {
@@ -43,6 +43,12 @@ public:
 
     void Call(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::FunctionCallbackInfo<v8::Value>& Info, std::function<void(void *)> OnCall);
 
+    // 对Targets里的每个对象调用该函数，共用一个参数buffer；Args可以是所有对象共用的一组参数，也可以是每个对象一组参数平铺成的数组
+    void BatchCall(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::FunctionCallbackInfo<v8::Value>& Info, v8::Local<v8::Array> Targets, v8::Local<v8::Object> Args, uint32 ArgsLength);
+
+    // 类的函数表发生变化（比如重定义了函数）时调用，让所有接口函数的解析缓存失效
+    static void InvalidateInterfaceCache();
+
 protected:
     std::vector<std::unique_ptr<FPropertyTranslator>> Arguments;
 
@@ -58,12 +64,90 @@ protected:
 
     void *ArgumentDefaultValues;
 
-    std::vector< v8::Local<v8::Value>> Args;
+    static const int INTERFACE_CACHE_SIZE = 4;
+
+    // 接口函数解析缓存，Class只做比较不解引用，Function用弱引用检查有效性
+    struct FInterfaceCacheEntry
+    {
+        UClass *Class;
+        TWeakObjectPtr<UFunction> Function;
+    };
+
+    FInterfaceCacheEntry InterfaceCache[INTERFACE_CACHE_SIZE];
+
+    uint32 InterfaceCacheGeneration;
+
+    static uint32 GlobalInterfaceCacheGeneration;
+
+    UFunction *ResolveInterfaceFunction(UObject *CallObject);
+
+#if !defined(WITHOUT_DIRECT_NATIVE_CALL)
+    // C++实现的非网络函数，可以跳过ProcessEvent直接调用exec thunk
+    bool CanCallNativeDirectly;
+#endif
+
+    FORCEINLINE void ProcessEvent(UObject *CallObject, UFunction *CallFunction, void *Params)
+    {
+#if !defined(WITHOUT_DIRECT_NATIVE_CALL)
+        if (CanCallNativeDirectly && CallFunction == Function)
+        {
+            CallNativeDirectly(CallObject, CallFunction, Params);
+            return;
+        }
+#endif
+        CallObject->UObject::ProcessEvent(CallFunction, Params);
+    }
+
+#if !defined(WITHOUT_DIRECT_NATIVE_CALL)
+    static void CallNativeDirectly(UObject *CallObject, UFunction *CallFunction, void *Params);
+#endif
+
+#if defined(USE_FAST_CALL)
+    enum class EFastArgKind : uint8
+    {
+        Int8,
+        UInt8,
+        Int16,
+        UInt16,
+        Int32,
+        UInt32,
+        Float,
+        Double,
+        Bool,
+        Generic, // 走FPropertyTranslator的虚函数
+    };
+
+    struct FFastArg
+    {
+        EFastArgKind Kind;
+        int32 Offset;
+    };
+
+    // 构造时生成的调用计划，FastCallEnable为false时走通用路径
+    std::vector<FFastArg> FastArgs;
+
+    FFastArg FastReturn;
+
+    bool FastCallEnable;
+
+    // 所有参数都是ZeroConstructor + NoDestructor时，可以用Memzero代替InitializeStruct，并且不需要DestroyStruct
+    bool ParamsIsPOD;
+
+    bool HasOutParams;
+
+    static EFastArgKind GetFastArgKind(PropertyMacro *Property);
+
+    void BuildFastCallPlan();
+#endif
 
 private:
     static void Call(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
     void Call(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+#if defined(USE_FAST_CALL)
+    void FastCall(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::FunctionCallbackInfo<v8::Value>& Info, UObject *CallObject);
+#endif
 };
 
 class FExtensionMethodTranslator : public FFunctionTranslator
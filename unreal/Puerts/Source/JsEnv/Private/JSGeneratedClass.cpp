@@ -162,6 +162,7 @@ void UJSGeneratedClass::Override(v8::Isolate* Isolate, UClass *Class, UFunction
         Class->Children = Function;
     }
     Class->AddFunctionToFunctionMap(Function, Function->GetFName());
+    puerts::FFunctionTranslator::InvalidateInterfaceCache();
 }
 
 void UJSGeneratedClass::InitPropertiesFromCustomList(uint8* DataPtr, const uint8* DefaultDataPtr)
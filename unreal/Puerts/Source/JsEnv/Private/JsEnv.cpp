@@ -32,6 +32,11 @@ void FJsEnv::LowMemoryNotification()
     GameScript->LowMemoryNotification();
 }
 
+void FJsEnv::SetGCSettings(const FJsEnvGCSettings& Settings)
+{
+    GameScript->SetGCSettings(Settings);
+}
+
 void FJsEnv::WaitDebugger(double timeout)
 {
     GameScript->WaitDebugger(timeout);
@@ -113,6 +113,14 @@ void FJsEnvGroup::InitExtensionMethodsMap()
     }
 }
 
+void FJsEnvGroup::SetGCSettings(const FJsEnvGCSettings& Settings)
+{
+    for (int i = 0; i < JsEnvList.size(); i++)
+    {
+        JsEnvList[i]->SetGCSettings(Settings);
+    }
+}
+
 void FJsEnvGroup::ReloadModule(FName ModuleName, const FString& JsSource)
 {
     for (int i = 0; i < JsEnvList.size(); i++)
@@ -6,9 +6,11 @@
 */
 
 #include "JsEnvImpl.h"
+#include "JsEnvModule.h"
 #include "DynamicDelegateProxy.h"
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
+#include "Misc/App.h"
 #include "StructWrapper.h"
 #include "DelegateWrapper.h"
 #include "ContainerWrapper.h"
@@ -27,6 +29,7 @@
 #include "TypeScriptObject.h"
 #include "TypeScriptGeneratedClass.h"
 #include "ContainerMeta.h"
+#include "StructMemoryPool.h"
 #include "Engine/UserDefinedEnum.h"
 
 #pragma warning(push, 0)  
@@ -277,6 +280,24 @@ FJsEnvImpl::FJsEnvImpl(std::shared_ptr<IJSModuleLoader> InModuleLoader, std::sha
         Self->ReleaseManualReleaseDelegate(Info);
     }, This)->GetFunction(Context).ToLocalChecked()).Check();
 
+    Puerts->Set(Context, FV8Utils::ToV8String(Isolate, "batchCall"), v8::FunctionTemplate::New(Isolate, [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        auto Self = static_cast<FJsEnvImpl*>((v8::Local<v8::External>::Cast(Info.Data()))->Value());
+        Self->BatchCall(Info);
+    }, This)->GetFunction(Context).ToLocalChecked()).Check();
+
+    Puerts->Set(Context, FV8Utils::ToV8String(Isolate, "mathStructTypedArrayScope"), v8::FunctionTemplate::New(Isolate, [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        auto Self = static_cast<FJsEnvImpl*>((v8::Local<v8::External>::Cast(Info.Data()))->Value());
+        Self->MathStructTypedArrayScope(Info);
+    }, This)->GetFunction(Context).ToLocalChecked()).Check();
+
+    Puerts->Set(Context, FV8Utils::ToV8String(Isolate, "frameScope"), v8::FunctionTemplate::New(Isolate, [](const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        auto Self = static_cast<FJsEnvImpl*>((v8::Local<v8::External>::Cast(Info.Data()))->Value());
+        Self->FrameScope(Info);
+    }, This)->GetFunction(Context).ToLocalChecked()).Check();
+
     ArrayTemplate = v8::UniquePersistent<v8::FunctionTemplate>(Isolate, FScriptArrayWrapper::ToFunctionTemplate(Isolate));
 
     SetTemplate = v8::UniquePersistent<v8::FunctionTemplate>(Isolate, FScriptSetWrapper::ToFunctionTemplate(Isolate));
@@ -313,7 +334,7 @@ FJsEnvImpl::FJsEnvImpl(std::shared_ptr<IJSModuleLoader> InModuleLoader, std::sha
 
     ReloadJs.Reset(Isolate, Puerts->Get(Context, FV8Utils::ToV8String(Isolate, "__reload")).ToLocalChecked().As<v8::Function>());
 
-    DelegateProxysCheckerHandler = FTicker::GetCoreTicker().AddTicker(TBaseDelegate<bool, float>::CreateRaw(this, &FJsEnvImpl::CheckDelegateProxys), 1);
+    FinalizeTickerHandler = FTicker::GetCoreTicker().AddTicker(TBaseDelegate<bool, float>::CreateRaw(this, &FJsEnvImpl::TickFinalize), 0);
 
     ManualReleaseCallbackMap.Reset(Isolate, v8::Map::New(Isolate));
 }
@@ -321,25 +342,39 @@ FJsEnvImpl::FJsEnvImpl(std::shared_ptr<IJSModuleLoader> InModuleLoader, std::sha
 // #lizard forgives
 FJsEnvImpl::~FJsEnvImpl()
 {
-    for(int i = 0; i < ManualReleaseCallbackList.size(); i++)
+    for (auto& DelegateProxy : DelegateProxys)
     {
-        if (ManualReleaseCallbackList[i].IsValid())
+        if (DelegateProxy.IsValid())
         {
-            ManualReleaseCallbackList[i].Get()->JsFunction.Reset();
+            DelegateProxy->JsFunction.Reset();
         }
     }
+    DelegateProxys.clear();
     ManualReleaseCallbackMap.Reset();
     InspectorMessageHandler.Reset();
     Require.Reset();
     ReloadJs.Reset();
     JsPromiseRejectCallback.Reset();
 
-    FTicker::GetCoreTicker().RemoveTicker(DelegateProxysCheckerHandler);
+    FTicker::GetCoreTicker().RemoveTicker(FinalizeTickerHandler);
+
+    if (GCTickerHandler.IsValid())
+    {
+        FTicker::GetCoreTicker().RemoveTicker(GCTickerHandler);
+    }
+    if (PreGarbageCollectHandler.IsValid())
+    {
+        FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandler);
+    }
 
     {
         auto Isolate = MainIsolate;
         v8::Isolate::Scope IsolateScope(Isolate);
         v8::HandleScope HandleScope(Isolate);
+        FinalizeCollectedWrappers();
+        FrameStructs.clear();
+        FrameObjects.clear();
+
         for (auto Iter = ClassToTemplateMap.begin(); Iter != ClassToTemplateMap.end(); Iter++)
         {
             Iter->second.Reset();
@@ -350,10 +385,25 @@ FJsEnvImpl::~FJsEnvImpl()
             Iter->second.Reset();
         }
 
+#ifndef WITH_QUICKJS
+        for (int i = 0; i < NAME_CACHE_SIZE; ++i)
+        {
+            NameToStringCache[i].String.Reset();
+            StringToNameCache[i].String.Reset();
+        }
+#endif
+
+#if defined(OBJECT_MAP_BY_INDEX)
+        for (auto& Handle : ObjectMap)
+        {
+            Handle.Reset();
+        }
+#else
         for (auto Iter = ObjectMap.begin(); Iter != ObjectMap.end(); Iter++)
         {
             Iter->second.Reset();
         }
+#endif
 
         for (auto Iter = GeneratedObjectMap.begin(); Iter != GeneratedObjectMap.end(); Iter++)
         {
@@ -380,23 +430,13 @@ FJsEnvImpl::~FJsEnvImpl()
         {
             if (Iter->second.IsValid())
             {
-                Iter->second.Get()->DestroyStruct(Iter->first);
-                FMemory::Free(Iter->first);
+                FScriptStructWrapper::Free(Iter->second.Get(), Iter->first);
             }
         }
 
         for (auto Iter = DelegateMap.begin(); Iter != DelegateMap.end(); Iter++)
         {
             Iter->second.JSObject.Reset();
-            if (Iter->second.Proxy.IsValid())
-            {
-                Iter->second.Proxy->JsFunction.Reset();
-            }
-            for (auto ProxyIter = Iter->second.Proxys.CreateIterator(); ProxyIter; ++ProxyIter)
-            {
-                if (!(*ProxyIter).IsValid()) { continue; }
-                (*ProxyIter)->JsFunction.Reset();
-            }
             if (!Iter->second.PassByPointer)
             {
                 delete ((FScriptDelegate *)Iter->first);
@@ -416,6 +456,8 @@ FJsEnvImpl::~FJsEnvImpl()
         }
         BindInfoMap.clear();
 
+        ObjectMergers.clear();
+
         for (auto& Pair : TickerDelegateHandleMap)
         {
             FTicker::GetCoreTicker().RemoveTicker(*(Pair.first));
@@ -642,6 +684,101 @@ void FJsEnvImpl::LowMemoryNotification()
     MainIsolate->LowMemoryNotification();
 }
 
+void FJsEnvImpl::SetGCSettings(const FJsEnvGCSettings& Settings)
+{
+    GCSettings = Settings;
+
+#ifndef WITH_QUICKJS
+    if (GCSettings.GCBeforeUEGC && !PreGarbageCollectHandler.IsValid())
+    {
+        PreGarbageCollectHandler = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddRaw(this, &FJsEnvImpl::OnPreGarbageCollect);
+    }
+    else if (!GCSettings.GCBeforeUEGC && PreGarbageCollectHandler.IsValid())
+    {
+        FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandler);
+        PreGarbageCollectHandler.Reset();
+    }
+
+#if PLATFORM_ANDROID || PLATFORM_WINDOWS || PLATFORM_IOS || PLATFORM_MAC || PLATFORM_LINUX
+    if (GCSettings.IdleGCTimeBudgetMs > 0 && !V8Platform)
+    {
+        V8Platform = static_cast<v8::Platform*>(IJsEnvModule::Get().GetV8Platform());
+    }
+#endif
+
+    const bool NeedTick = (GCSettings.IdleGCTimeBudgetMs > 0 && V8Platform) || GCSettings.MemoryPressureThresholdMB > 0;
+    if (NeedTick && !GCTickerHandler.IsValid())
+    {
+        HeapCheckElapsed = 0;
+        GCTickerHandler = FTicker::GetCoreTicker().AddTicker(TBaseDelegate<bool, float>::CreateRaw(this, &FJsEnvImpl::TickGC), 0);
+    }
+    else if (!NeedTick && GCTickerHandler.IsValid())
+    {
+        FTicker::GetCoreTicker().RemoveTicker(GCTickerHandler);
+        GCTickerHandler.Reset();
+    }
+
+    if (GCSettings.MemoryPressureThresholdMB <= 0 && UnderMemoryPressure)
+    {
+        UnderMemoryPressure = false;
+        MainIsolate->MemoryPressureNotification(v8::MemoryPressureLevel::kNone);
+    }
+#endif
+}
+
+bool FJsEnvImpl::TickGC(float tick)
+{
+#ifndef WITH_QUICKJS
+    static const double HEAP_CHECK_INTERVAL = 1.0;
+
+    auto Isolate = MainIsolate;
+    v8::Isolate::Scope IsolateScope(Isolate);
+    v8::HandleScope HandleScope(Isolate);
+
+    if (GCSettings.MemoryPressureThresholdMB > 0)
+    {
+        HeapCheckElapsed += tick;
+        if (HeapCheckElapsed >= HEAP_CHECK_INTERVAL)
+        {
+            HeapCheckElapsed = 0;
+            v8::HeapStatistics Statistics;
+            Isolate->GetHeapStatistics(&Statistics);
+            const bool Pressure = Statistics.used_heap_size() > static_cast<size_t>(GCSettings.MemoryPressureThresholdMB) * 1024 * 1024;
+            // 只在状态变化时通知，避免每次都触发v8的紧急回收
+            if (Pressure != UnderMemoryPressure)
+            {
+                UnderMemoryPressure = Pressure;
+                Isolate->MemoryPressureNotification(Pressure ? v8::MemoryPressureLevel::kModerate : v8::MemoryPressureLevel::kNone);
+            }
+        }
+    }
+
+    if (GCSettings.IdleGCTimeBudgetMs > 0 && V8Platform)
+    {
+        // ticker里没有真正的空闲时机，用上一帧限帧等待的时间近似：上一帧有空闲才给v8，且不超过空闲时长，不会拉低帧率
+        const double IdleTime = FMath::Min(FApp::GetIdleTime(), GCSettings.IdleGCTimeBudgetMs / 1000.0);
+        if (IdleTime > 0)
+        {
+            Isolate->IdleNotificationDeadline(V8Platform->MonotonicallyIncreasingTime() + IdleTime);
+        }
+    }
+#endif
+    return true;
+}
+
+void FJsEnvImpl::OnPreGarbageCollect()
+{
+#ifndef WITH_QUICKJS
+    // 先回收已经没人引用的wrapper，让它们引用的UObject能在这一轮UE GC里释放
+    // 公开接口里只有critical级别的内存压力通知会在当前线程同步做一次完整GC，做完恢复原来的级别
+    auto Isolate = MainIsolate;
+    v8::Isolate::Scope IsolateScope(Isolate);
+    v8::HandleScope HandleScope(Isolate);
+    Isolate->MemoryPressureNotification(v8::MemoryPressureLevel::kCritical);
+    Isolate->MemoryPressureNotification(UnderMemoryPressure ? v8::MemoryPressureLevel::kModerate : v8::MemoryPressureLevel::kNone);
+#endif
+}
+
 
 void FJsEnvImpl::MakeSureInject(UTypeScriptGeneratedClass* TypeScriptGeneratedClass, bool ForceReinject, bool RebindObject)
 {
@@ -687,6 +824,7 @@ void FJsEnvImpl::MakeSureInject(UTypeScriptGeneratedClass* TypeScriptGeneratedCl
                 BindInfo.Name = *ModuleName;
                 BindInfo.Prototype.Reset(Isolate, v8::Object::New(Isolate));
                 BindInfoMap[TypeScriptGeneratedClass] = std::move(BindInfo);
+                MarkJsKnownObject(TypeScriptGeneratedClass);
             }
 
             v8::TryCatch TryCatch(Isolate);
@@ -778,6 +916,7 @@ void FJsEnvImpl::MakeSureInject(UTypeScriptGeneratedClass* TypeScriptGeneratedCl
                                         v8::UniquePersistent<v8::Function>(Isolate, v8::Local<v8::Function>::Cast(MaybeValue.ToLocalChecked())),
                                         std::make_unique<puerts::FFunctionTranslator>(Function)
                                     };
+                                    MarkJsKnownObject(Function);
                                     TypeScriptGeneratedClass->RedirectToTypeScript(Function);
                                     overrided.Add(FunctionFName);
                                 }
@@ -819,6 +958,7 @@ void FJsEnvImpl::MakeSureInject(UTypeScriptGeneratedClass* TypeScriptGeneratedCl
                                 //TsConstruct(TypeScriptGeneratedClass, Object);
                                 auto JSObject = FindOrAdd(Isolate, Context, Object->GetClass(), Object)->ToObject(Context).ToLocalChecked();
                                 GeneratedObjectMap[Object] = v8::UniquePersistent<v8::Value>(MainIsolate, JSObject);
+                                MarkJsKnownObject(Object);
                                 UnBind(TypeScriptGeneratedClass, Object);
                             }
                         }
@@ -965,33 +1105,67 @@ FString FJsEnvImpl::CurrentStackTrace()
 #endif
 }
 
+v8::UniquePersistent<v8::Value>* FJsEnvImpl::FindObjectHandle(UObject *UEObject)
+{
+#if defined(OBJECT_MAP_BY_INDEX)
+    const int32 ObjectIndex = GUObjectArray.ObjectToIndex(UEObject);
+    if (ObjectIndex >= 0 && ObjectIndex < static_cast<int32>(ObjectMap.size()) && !ObjectMap[ObjectIndex].IsEmpty())
+    {
+        return &ObjectMap[ObjectIndex];
+    }
+    return nullptr;
+#else
+    auto Iter = ObjectMap.find(UEObject);
+    return Iter == ObjectMap.end() ? nullptr : &Iter->second;
+#endif
+}
+
 void FJsEnvImpl::Bind(UClass *Class, UObject *UEObject, v8::Local<v8::Object> JSObject) // Just call in FClassReflection::Call, new a Object
 {
+    // 先处理已回收的，保证同一地址上旧对象的解绑在新对象Retain之前
+    FinalizeCollectedWrappers();
     UserObjectRetainer.Retain(UEObject);
+    MarkJsKnownObject(UEObject);
     FV8Utils::SetPointer(MainIsolate, JSObject, UEObject, 0);
     FV8Utils::SetPointer(MainIsolate, JSObject, nullptr, 1);
-    ObjectMap[UEObject] = v8::UniquePersistent<v8::Value>(MainIsolate, JSObject);
-    ObjectMap[UEObject].SetWeak<UClass>(Class, FClassWrapper::OnGarbageCollected, v8::WeakCallbackType::kInternalFields);
+#if defined(OBJECT_MAP_BY_INDEX)
+    const int32 ObjectIndex = GUObjectArray.ObjectToIndex(UEObject);
+    if (ObjectIndex >= static_cast<int32>(ObjectMap.size()))
+    {
+        ObjectMap.resize(FMath::Max(ObjectIndex + 1, GUObjectArray.GetObjectArrayNum()));
+    }
+    auto& Handle = ObjectMap[ObjectIndex];
+#else
+    auto& Handle = ObjectMap[UEObject];
+#endif
+    Handle = v8::UniquePersistent<v8::Value>(MainIsolate, JSObject);
+    Handle.SetWeak<void>(Class, OnWrapperGarbageCollected<ECollectedWrapper::Object>, v8::WeakCallbackType::kInternalFields);
 }
 
 void FJsEnvImpl::UnBind(UClass *Class, UObject *UEObject, bool ResetPointer)
 {
-    auto Iter = ObjectMap.find(UEObject);
-    if (Iter != ObjectMap.end())
+    auto Handle = FindObjectHandle(UEObject);
+    if (Handle)
     {
-        if (ResetPointer)
+        // 已被v8回收、还没处理的句柄是空的
+        if (ResetPointer && !Handle->IsEmpty())
         {
             auto Isolate = MainIsolate;
             v8::Isolate::Scope IsolateScope(Isolate);
             v8::HandleScope HandleScope(Isolate);
-            auto Context = DefaultContext.Get(Isolate);
-            v8::Context::Scope ContextScope(Context);
 
-            FV8Utils::SetPointer(MainIsolate, Iter->second.Get(Isolate).As<v8::Object>(), RELEASED_UOBJECT, 0);
+            FV8Utils::SetPointer(MainIsolate, Handle->Get(Isolate).As<v8::Object>(), RELEASED_UOBJECT, 0);
+            // 指针已经失效，不能再走弱引用回调
+            Handle->ClearWeak();
         }
+#if defined(OBJECT_MAP_BY_INDEX)
+        Handle->Reset();
+#else
         ObjectMap.erase(UEObject);
-        UserObjectRetainer.Release(UEObject);
+#endif
     }
+    // 按下标存时，已回收的空句柄查不到，Retain过的对象也要释放
+    UserObjectRetainer.Release(UEObject);
 }
 
 void FJsEnvImpl::UnBind(UClass *Class, UObject *UEObject)
@@ -1006,8 +1180,8 @@ v8::Local<v8::Value> FJsEnvImpl::FindOrAdd(v8::Isolate* Isolate, v8::Local<v8::C
         return v8::Undefined(Isolate);
     }
 
-    auto Iter = ObjectMap.find(UEObject);
-    if (Iter == ObjectMap.end())//create and link
+    auto Handle = FindObjectHandle(UEObject);
+    if (!Handle || Handle->IsEmpty())//create and link
     {
         auto Iter2 = GeneratedObjectMap.find(UEObject);
         if (Iter2 != GeneratedObjectMap.end()) //TODO: 后续尝试改为新建一个对象，这个对象持有UObject的引用，并且把调用转发到Iter2->second
@@ -1020,7 +1194,7 @@ v8::Local<v8::Value> FJsEnvImpl::FindOrAdd(v8::Isolate* Isolate, v8::Local<v8::C
     }
     else
     {
-        return v8::Local<v8::Value>::New(Isolate, Iter->second);
+        return v8::Local<v8::Value>::New(Isolate, *Handle);
     }
 }
 
@@ -1034,7 +1208,7 @@ v8::Local<v8::Value> FJsEnvImpl::FindOrAddStruct(v8::Isolate* Isolate, v8::Local
     if (!PassByPointer)
     {
         auto Iter = StructMap.find(Ptr);
-        if (Iter != StructMap.end())
+        if (Iter != StructMap.end() && !Iter->second.IsEmpty())
         {
             return v8::Local<v8::Value>::New(Isolate, Iter->second);
         }
@@ -1056,7 +1230,7 @@ v8::Local<v8::Value> FJsEnvImpl::FindOrAddCData(v8::Isolate* Isolate, v8::Local<
     if (!PassByPointer)
     {
         auto Iter = CDataMap.find(Ptr);
-        if (Iter != CDataMap.end())
+        if (Iter != CDataMap.end() && !Iter->second.IsEmpty())
         {
             return v8::Local<v8::Value>::New(Isolate, Iter->second);
         }
@@ -1125,12 +1299,15 @@ v8::Local<v8::Value> FJsEnvImpl::FindOrAddDelegate(v8::Isolate* Isolate, v8::Loc
         DelegateMap[DelegatePtr] = {
             v8::UniquePersistent<v8::Object>(Isolate, JSObject),
             TWeakObjectPtr<UObject>(Owner),
+            Owner,
             DelegateProperty,
             MulticastDelegateProperty,
             Function,
             PassByPointer,
             nullptr
         };
+        DelegateOwnerMap[Owner].push_back(DelegatePtr);
+        MarkJsKnownObject(Owner);
         return JSObject;
     }
 }
@@ -1140,6 +1317,7 @@ v8::Local<v8::Value> FJsEnvImpl::CreateArray(v8::Isolate* Isolate, v8::Local<v8:
     auto Array = FixSizeArrayTemplate.Get(Isolate)->GetFunction(Context).ToLocalChecked()->NewInstance(Context).ToLocalChecked();
     FV8Utils::SetPointer(Isolate, Array, ArrayPtr, 0);
     FV8Utils::SetPointer(Isolate, Array, Property, 1);
+    TrackFrameObject(ArrayPtr, Array);
     return Array;
 }
 
@@ -1179,6 +1357,7 @@ void FJsEnvImpl::Construct(UClass* Class, UObject* Object, const v8::UniquePersi
 
     auto JSObject = FindOrAdd(Isolate, Context, Class, Object)->ToObject(Context).ToLocalChecked();
     GeneratedObjectMap[Object] = v8::UniquePersistent<v8::Value>(MainIsolate, JSObject);
+    MarkJsKnownObject(Object);
     UnBind(Class, Object);
 
     if (!Prototype.IsEmpty())
@@ -1216,6 +1395,7 @@ void FJsEnvImpl::TsConstruct(UTypeScriptGeneratedClass* Class, UObject* Object)
         {
             JSObject = FindOrAdd(Isolate, Context, Object->GetClass(), Object)->ToObject(Context).ToLocalChecked();
             GeneratedObjectMap[Object] = v8::UniquePersistent<v8::Value>(MainIsolate, JSObject);
+            MarkJsKnownObject(Object);
             UnBind(Class, Object);
         }
         else
@@ -1246,6 +1426,13 @@ void FJsEnvImpl::TsConstruct(UTypeScriptGeneratedClass* Class, UObject* Object)
 
 void FJsEnvImpl::NotifyUObjectDeleted(const class UObjectBase *ObjectBase, int32 Index)
 {
+    // 关卡卸载时大量对象被删除，绝大部分js都没接触过，先用位图过滤
+    if (Index < 0 || Index >= JsKnownObjects.Num() || !JsKnownObjects[Index])
+    {
+        return;
+    }
+    JsKnownObjects[Index] = false;
+
     auto Iter = GeneratedObjectMap.find(ObjectBase);
     if (Iter != GeneratedObjectMap.end())
     {
@@ -1253,13 +1440,11 @@ void FJsEnvImpl::NotifyUObjectDeleted(const class UObjectBase *ObjectBase, int32
         auto Isolate = MainIsolate;
         v8::Isolate::Scope IsolateScope(Isolate);
         v8::HandleScope HandleScope(Isolate);
-        auto Context = v8::Local<v8::Context>::New(Isolate, DefaultContext);
-        v8::Context::Scope ContextScope(Context);
 
-        auto JSObject = Iter->second.Get(Isolate)->ToObject(Context).ToLocalChecked();
+        auto JSObject = Iter->second.Get(Isolate).As<v8::Object>();
         FV8Utils::SetPointer(Isolate, JSObject, nullptr, 0);
         FV8Utils::SetPointer(Isolate, JSObject, nullptr, 1);
-        GeneratedObjectMap.erase(ObjectBase);
+        GeneratedObjectMap.erase(Iter);
     }
     
     TryReleaseType((UStruct*)ObjectBase);
@@ -1273,6 +1458,8 @@ void FJsEnvImpl::NotifyUObjectDeleted(const class UObjectBase *ObjectBase, int32
 
     UnBind(nullptr, (UObject*)ObjectBase, true);
 
+    RemoveOwnedDelegates(ObjectBase);
+
     UClass *Class = (UClass *)ObjectBase;
     if (GeneratedClasses.Contains(Class))
     {
@@ -1280,6 +1467,28 @@ void FJsEnvImpl::NotifyUObjectDeleted(const class UObjectBase *ObjectBase, int32
     }
 
     TsFunctionMap.erase((UFunction*)ObjectBase);
+
+    BatchCallTranslatorMap.erase((UFunction*)ObjectBase);
+}
+
+void FJsEnvImpl::MarkJsKnownObject(const class UObjectBase *Object)
+{
+    const int32 Index = GUObjectArray.ObjectToIndex(Object);
+    if (Index >= JsKnownObjects.Num())
+    {
+        const int32 NewNum = FMath::Max(Index + 1, GUObjectArray.GetObjectArrayNum());
+        while (JsKnownObjects.Num() < NewNum)
+        {
+            JsKnownObjects.Add(false);
+        }
+    }
+    JsKnownObjects[Index] = true;
+}
+
+bool FJsEnvImpl::TickFinalize(float tick)
+{
+    FinalizeCollectedWrappers();
+    return true;
 }
 
 void FJsEnvImpl::TryReleaseType(UStruct *Struct) 
@@ -1367,6 +1576,7 @@ void FJsEnvImpl::ExecuteDelegate(v8::Isolate* Isolate, v8::Local<v8::Context>& C
     if (Iter == DelegateMap.end())
     {
         FV8Utils::ThrowException(Isolate, "can not find the delegate!");
+        return;
     }
     auto SignatureFunction = Iter->second.SignatureFunction;
     if (JsCallbackPrototypeMap.find(SignatureFunction) == JsCallbackPrototypeMap.end())
@@ -1401,17 +1611,23 @@ bool FJsEnvImpl::AddToDelegate(v8::Isolate* Isolate, v8::Local<v8::Context>& Con
     if (!Iter->second.Owner.IsValid())
     {
         Logger->Warn("try to bind a delegate with invalid owner!");
+        const UObjectBase* OwnerObject = Iter->second.OwnerObject;
+        const bool PassByPointer = Iter->second.PassByPointer;
         ClearDelegate(Isolate, Context, DelegatePtr);
-        if (!Iter->second.PassByPointer)
+        UnlinkDelegateOwner(OwnerObject, DelegatePtr);
+        if (!PassByPointer)
         {
-            delete ((FScriptDelegate *)Iter->first);
+            delete ((FScriptDelegate *)DelegatePtr);
         }
-        DelegateMap.erase(Iter);
+        DelegateMap.erase(DelegatePtr);
         return false;
     }
     if (Iter->second.Proxy.IsValid())
     {
         ClearDelegate(Isolate, Context, DelegatePtr);
+        // 不依赖ClearDelegate不改动DelegateMap，迭代器重新取
+        Iter = DelegateMap.find(DelegatePtr);
+        check(Iter != DelegateMap.end());
     }
     auto JSObject = Iter->second.JSObject.Get(Isolate);
     auto Map = v8::Local<v8::Map>::Cast(JSObject->Get(Context, 0).ToLocalChecked());
@@ -1420,13 +1636,8 @@ bool FJsEnvImpl::AddToDelegate(v8::Isolate* Isolate, v8::Local<v8::Context>& Con
     if (MaybeProxy.IsEmpty() || !MaybeProxy.ToLocalChecked()->IsExternal())
     {
         //UE_LOG(LogTemp, Warning, TEXT("new delegate proxy"));
-        DelegateProxy = NewObject<UDynamicDelegateProxy>();
+        DelegateProxy = NewDelegateProxy(Isolate, Iter->second.SignatureFunction, JsFunction);
         DelegateProxy->Owner = Iter->second.Owner;
-        DelegateProxy->SignatureFunction = Iter->second.SignatureFunction;
-        DelegateProxy->DynamicInvoker = DynamicInvoker;
-        DelegateProxy->JsFunction = v8::UniquePersistent<v8::Function>(Isolate, JsFunction);
-            
-        SysObjectRetainer.Retain(DelegateProxy);
         auto ReturnVal = Map->Set(Context, JsFunction, v8::External::New(Context->GetIsolate(), DelegateProxy));
     }
     else
@@ -1469,16 +1680,9 @@ FScriptDelegate FJsEnvImpl::NewManualReleaseDelegate(v8::Isolate* Isolate, v8::L
     UDynamicDelegateProxy *DelegateProxy = nullptr;
     if (MaybeProxy.IsEmpty() || !MaybeProxy.ToLocalChecked()->IsExternal())
     {
-        DelegateProxy = NewObject<UDynamicDelegateProxy>();
+        DelegateProxy = NewDelegateProxy(Isolate, SignatureFunction, JsFunction);
         DelegateProxy->Owner = DelegateProxy;
-        DelegateProxy->SignatureFunction = SignatureFunction;
-        DelegateProxy->DynamicInvoker = DynamicInvoker;
-        DelegateProxy->JsFunction = v8::UniquePersistent<v8::Function>(Isolate, JsFunction);
-            
-        SysObjectRetainer.Retain(DelegateProxy);
         __USE(CallbacksMap->Set(Context, JsFunction, v8::External::New(Context->GetIsolate(), DelegateProxy)));
-
-        ManualReleaseCallbackList.push_back(DelegateProxy);
     }
     else
     {
@@ -1506,19 +1710,244 @@ void FJsEnvImpl::ReleaseManualReleaseDelegate(const v8::FunctionCallbackInfo<v8:
     {
         __USE(CallbacksMap->Set(Context, Info[0], v8::Undefined(Isolate)));
         auto DelegateProxy = Cast<UDynamicDelegateProxy>(static_cast<UObject*>(v8::Local<v8::External>::Cast(MaybeProxy.ToLocalChecked())->Value()));
-        for ( auto it = ManualReleaseCallbackList.begin(); it != ManualReleaseCallbackList.end(); )
+        if (DelegateProxy)
+        {
+            ReleaseDelegateProxy(DelegateProxy);
+        }
+    }
+}
+
+void FJsEnvImpl::BatchCall(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::Isolate::Scope IsolateScope(Isolate);
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+    v8::Context::Scope ContextScope(Context);
+
+    CHECK_V8_ARGS_LEN(2);
+
+    if (!Info[1]->IsArray())
+    {
+        FV8Utils::ThrowException(Isolate, "Bad parameters #1, expect an array of targets.");
+        return;
+    }
+    auto Targets = v8::Local<v8::Array>::Cast(Info[1]);
+
+    if (Targets->Length() == 0)
+    {
+        return;
+    }
+
+    UFunction* Function = nullptr;
+    if (Info[0]->IsString())
+    {
+        UObject* First = FV8Utils::GetUObject(Context, Targets->Get(Context, 0).ToLocalChecked());
+        if (!First || FV8Utils::IsReleasedPtr(First))
+        {
+            FV8Utils::ThrowException(Isolate, "access a null or invalid object, target #0");
+            return;
+        }
+        Function = First->GetClass()->FindFunctionByName(FName(*FV8Utils::ToFString(Isolate, Info[0])));
+    }
+    else
+    {
+        UObject* Object = FV8Utils::GetUObject(Context, Info[0]);
+        Function = (Object && !FV8Utils::IsReleasedPtr(Object)) ? Cast<UFunction>(Object) : nullptr;
+    }
+    if (!Function)
+    {
+        FV8Utils::ThrowException(Isolate, "Bad parameters #0, expect a function name or an UFunction.");
+        return;
+    }
+
+    v8::Local<v8::Object> Args;
+    uint32 ArgsLength = 0;
+    if (Info.Length() > 2 && !Info[2]->IsUndefined() && !Info[2]->IsNull())
+    {
+        if (Info[2]->IsArray())
+        {
+            ArgsLength = v8::Local<v8::Array>::Cast(Info[2])->Length();
+        }
+        else if (Info[2]->IsTypedArray())
+        {
+            ArgsLength = static_cast<uint32>(v8::Local<v8::TypedArray>::Cast(Info[2])->Length());
+        }
+        else
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #2, expect an array or typed array of arguments.");
+            return;
+        }
+        Args = Info[2]->ToObject(Context).ToLocalChecked();
+    }
+
+    auto Iter = BatchCallTranslatorMap.find(Function);
+    if (Iter == BatchCallTranslatorMap.end())
+    {
+        Iter = BatchCallTranslatorMap.emplace(Function, std::make_unique<FFunctionTranslator>(Function)).first;
+        MarkJsKnownObject(Function);
+    }
+    Iter->second->BatchCall(Isolate, Context, Info, Targets, Args, ArgsLength);
+}
+
+void FJsEnvImpl::MathStructTypedArrayScope(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::Isolate::Scope IsolateScope(Isolate);
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+    v8::Context::Scope ContextScope(Context);
+
+    CHECK_V8_ARGS(Int32, Function);
+
+    int32 Mode = Info[0]->Int32Value(Context).ToChecked();
+    if (Mode != 32 && Mode != 64)
+    {
+        FV8Utils::ThrowException(Isolate, "Bad parameters #0, expect 32 or 64.");
+        return;
+    }
+
+    // 只作用于fn执行期间，异常时也恢复
+    const int32 PrevMode = MathStructTypedArrayMode;
+    MathStructTypedArrayMode = Mode;
+    auto Result = Info[1].As<v8::Function>()->Call(Context, v8::Undefined(Isolate), 0, nullptr);
+    MathStructTypedArrayMode = PrevMode;
+
+    if (!Result.IsEmpty())
+    {
+        Info.GetReturnValue().Set(Result.ToLocalChecked());
+    }
+}
+
+void FJsEnvImpl::FrameScope(const v8::FunctionCallbackInfo<v8::Value>& Info)
+{
+    v8::Isolate* Isolate = Info.GetIsolate();
+    v8::Isolate::Scope IsolateScope(Isolate);
+    v8::HandleScope HandleScope(Isolate);
+    v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+    v8::Context::Scope ContextScope(Context);
+
+    CHECK_V8_ARGS(Function);
+
+    const auto Mark = FrameStructArena.GetMark();
+    const size_t FrameStart = FrameStructs.size();
+    ++FrameScopeDepth;
+    auto Result = Info[0].As<v8::Function>()->Call(Context, v8::Undefined(Isolate), 0, nullptr);
+    --FrameScopeDepth;
+
+    // 和UObject销毁时一样把js对象上的指针置空，不经过弱引用回调；异常时也要清理，异常继续往上抛
+    size_t Keep = 0;
+    for (size_t i = 0; i < FrameObjects.size(); ++i)
+    {
+        auto& FrameObject = FrameObjects[i];
+        if (FParamsBufferArena::IsAllocatedAfter(FrameObject.Position, Mark))
+        {
+            FV8Utils::SetPointer(Isolate, FrameObject.JSObject.Get(Isolate), nullptr, 0);
+            FrameObject.JSObject.Reset();
+        }
+        else
         {
-            if (!it->IsValid())
+            if (Keep != i)
             {
-                it = ManualReleaseCallbackList.erase(it);
-            } else if (it->Get() == DelegateProxy) {
-                DelegateProxy->JsFunction.Reset();
-                it = ManualReleaseCallbackList.erase(it);
-            } else {
-                ++it;
+                FrameObjects[Keep] = std::move(FrameObject);
             }
+            ++Keep;
         }
     }
+    FrameObjects.resize(Keep);
+
+    for (size_t i = FrameStart; i < FrameStructs.size(); ++i)
+    {
+        FrameStructs[i].ScriptStruct->DestroyStruct(FrameStructs[i].Ptr);
+    }
+    FrameStructs.resize(FrameStart);
+    FrameStructArena.Reset(Mark);
+
+    if (!Result.IsEmpty())
+    {
+        Info.GetReturnValue().Set(Result.ToLocalChecked());
+    }
+}
+
+v8::Local<v8::Value> FJsEnvImpl::TryAddFrameStruct(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, UScriptStruct* ScriptStruct, const void* ValuePtr)
+{
+    if (FrameScopeDepth == 0)
+    {
+        return v8::Local<v8::Value>();
+    }
+
+    UScriptStruct::ICppStructOps *CppStructOps = ScriptStruct->GetCppStructOps();
+    const int32 Alignment = CppStructOps ? CppStructOps->GetAlignment() : ScriptStruct->GetMinAlignment();
+    if (Alignment > static_cast<int32>(FParamsBufferArena::ALIGNMENT))
+    {
+        return v8::Local<v8::Value>();
+    }
+
+    void* Ptr = FrameStructArena.Alloc(ScriptStruct->GetStructureSize());
+    ScriptStruct->InitializeStruct(Ptr);
+    ScriptStruct->CopyScriptStruct(Ptr, ValuePtr);
+    // 按指针绑定，不进StructMap也不设弱引用，生命周期由frameScope管理，js对象在BindStruct里登记
+    FrameStructs.push_back({ ScriptStruct, Ptr });
+    return FindOrAddStruct(Isolate, Context, ScriptStruct, Ptr, true);
+}
+
+bool FJsEnvImpl::IsFrameStructMemory(const void* Ptr)
+{
+    FParamsBufferArena::FMark Position;
+    return FrameScopeDepth > 0 && FrameStructArena.FindPosition(Ptr, Position);
+}
+
+void FJsEnvImpl::TrackFrameObject(const void* Ptr, v8::Local<v8::Object> JSObject)
+{
+    FParamsBufferArena::FMark Position;
+    if (FrameScopeDepth > 0 && FrameStructArena.FindPosition(Ptr, Position))
+    {
+        FrameObjects.push_back({ Position, v8::Global<v8::Object>(MainIsolate, JSObject) });
+    }
+}
+
+v8::Local<v8::String> FJsEnvImpl::NameToString(v8::Isolate* Isolate, const FName& Name)
+{
+#ifndef WITH_QUICKJS
+    FNameCacheEntry& Entry = NameToStringCache[GetTypeHash(Name) & (NAME_CACHE_SIZE - 1)];
+    // FName的==不区分大小写，Foo和foo会取到对方缓存的字符串
+    if (Entry.Name.IsEqual(Name, ENameCase::CaseSensitive) && !Entry.String.IsEmpty())
+    {
+        return Entry.String.Get(Isolate);
+    }
+    auto Result = v8::String::NewFromUtf8(Isolate, TCHAR_TO_UTF8(*Name.ToString()), v8::NewStringType::kInternalized).ToLocalChecked();
+    Entry.Name = Name;
+    Entry.String.Reset(Isolate, Result);
+
+    // 顺便填反向缓存，js把这个字符串传回来时不用再查name table
+    FNameCacheEntry& ReverseEntry = StringToNameCache[Result->GetIdentityHash() & (NAME_CACHE_SIZE - 1)];
+    ReverseEntry.Name = Name;
+    ReverseEntry.String.Reset(Isolate, Result);
+    return Result;
+#else
+    return FV8Utils::ToV8String(Isolate, Name);
+#endif
+}
+
+FName FJsEnvImpl::StringToName(v8::Isolate* Isolate, v8::Local<v8::Value> Value)
+{
+#ifndef WITH_QUICKJS
+    if (Value->IsString())
+    {
+        auto String = Value.As<v8::String>();
+        FNameCacheEntry& Entry = StringToNameCache[String->GetIdentityHash() & (NAME_CACHE_SIZE - 1)];
+        // 同一个internalized字符串时StrictEquals只比较指针
+        if (!Entry.String.IsEmpty() && Entry.String.Get(Isolate)->StrictEquals(String))
+        {
+            return Entry.Name;
+        }
+        FName Name(*FV8Utils::ToFString(Isolate, Value));
+        Entry.Name = Name;
+        Entry.String.Reset(Isolate, String);
+        return Name;
+    }
+#endif
+    return FName(*FV8Utils::ToFString(Isolate, Value));
 }
 
 bool FJsEnvImpl::RemoveFromDelegate(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, void *DelegatePtr, v8::Local<v8::Function> JsFunction)
@@ -1570,8 +1999,7 @@ bool FJsEnvImpl::RemoveFromDelegate(v8::Isolate* Isolate, v8::Local<v8::Context>
         auto ReturnVal = Map->Set(Context, JsFunction, v8::Undefined(Isolate));
 
         Iter->second.Proxys.Remove(DelegateProxy);
-        SysObjectRetainer.Release(DelegateProxy);
-        DelegateProxy->JsFunction.Reset();
+        ReleaseDelegateProxy(DelegateProxy);
     }
 
     return true;
@@ -1599,8 +2027,7 @@ bool FJsEnvImpl::ClearDelegate(v8::Isolate* Isolate, v8::Local<v8::Context>& Con
                 *(static_cast<FScriptDelegate*>(DelegatePtr)) = Delegate;
             }
 
-            SysObjectRetainer.Release(Iter->second.Proxy.Get());
-            Iter->second.Proxy->JsFunction.Reset();
+            ReleaseDelegateProxy(Iter->second.Proxy.Get());
             Iter->second.Proxy.Reset();
         }
     }
@@ -1623,8 +2050,7 @@ bool FJsEnvImpl::ClearDelegate(v8::Isolate* Isolate, v8::Local<v8::Context>& Con
         for (auto ProxyIter = Iter->second.Proxys.CreateIterator(); ProxyIter; ++ProxyIter)
         {
             if (!(*ProxyIter).IsValid()) { continue; }
-            (*ProxyIter)->JsFunction.Reset();
-            SysObjectRetainer.Release((*ProxyIter).Get());
+            ReleaseDelegateProxy((*ProxyIter).Get());
         }
         Iter->second.Proxys.Empty();
     }
@@ -1632,31 +2058,103 @@ bool FJsEnvImpl::ClearDelegate(v8::Isolate* Isolate, v8::Local<v8::Context>& Con
     return true;
 }
 
-bool FJsEnvImpl::CheckDelegateProxys(float tick)
+UDynamicDelegateProxy* FJsEnvImpl::NewDelegateProxy(v8::Isolate* Isolate, UFunction* SignatureFunction, v8::Local<v8::Function> JsFunction)
+{
+    UDynamicDelegateProxy* DelegateProxy = NewObject<UDynamicDelegateProxy>();
+    DelegateProxy->SignatureFunction = SignatureFunction;
+    DelegateProxy->DynamicInvoker = DynamicInvoker;
+    DelegateProxy->JsFunction = v8::UniquePersistent<v8::Function>(Isolate, JsFunction);
+    DelegateProxy->ProxyIndex = static_cast<int32>(DelegateProxys.size());
+    DelegateProxys.push_back(DelegateProxy);
+
+    SysObjectRetainer.Retain(DelegateProxy);
+    return DelegateProxy;
+}
+
+void FJsEnvImpl::ReleaseDelegateProxy(UDynamicDelegateProxy* DelegateProxy)
 {
-    std::vector<void*> PendingToRemove;
-    for (auto &KV : DelegateMap)
+    const int32 Index = DelegateProxy->ProxyIndex;
+    if (Index < 0 || Index >= static_cast<int32>(DelegateProxys.size()) || DelegateProxys[Index].Get() != DelegateProxy)
     {
-        if (!KV.second.Owner.IsValid())
+        return;
+    }
+    // 用最后一个元素填洞
+    if (Index != static_cast<int32>(DelegateProxys.size()) - 1)
+    {
+        DelegateProxys[Index] = DelegateProxys.back();
+        if (DelegateProxys[Index].IsValid())
         {
-            PendingToRemove.push_back(KV.first);
+            DelegateProxys[Index]->ProxyIndex = Index;
         }
     }
+    DelegateProxys.pop_back();
+
+    DelegateProxy->ProxyIndex = INDEX_NONE;
+    DelegateProxy->JsFunction.Reset();
+    // UE侧可能还有拷贝的delegate指向它，Owner置空后ProcessEvent不会再回调js
+    DelegateProxy->Owner.Reset();
+    SysObjectRetainer.Release(DelegateProxy);
+}
+
+void FJsEnvImpl::UnlinkDelegateOwner(const class UObjectBase* Owner, void* DelegatePtr)
+{
+    auto Iter = DelegateOwnerMap.find(Owner);
+    if (Iter == DelegateOwnerMap.end())
+    {
+        return;
+    }
+    auto& Delegates = Iter->second;
+    for (size_t i = 0; i < Delegates.size(); ++i)
+    {
+        if (Delegates[i] == DelegatePtr)
+        {
+            Delegates[i] = Delegates.back();
+            Delegates.pop_back();
+            break;
+        }
+    }
+    if (Delegates.empty())
+    {
+        DelegateOwnerMap.erase(Iter);
+    }
+}
+
+void FJsEnvImpl::RemoveOwnedDelegates(const class UObjectBase* Owner)
+{
+    auto OwnerIter = DelegateOwnerMap.find(Owner);
+    if (OwnerIter == DelegateOwnerMap.end())
+    {
+        return;
+    }
+    std::vector<void*> Delegates = std::move(OwnerIter->second);
+    DelegateOwnerMap.erase(OwnerIter);
+
     auto Isolate = MainIsolate;
     v8::Isolate::Scope IsolateScope(Isolate);
     v8::HandleScope HandleScope(Isolate);
     v8::Local<v8::Context> Context = DefaultContext.Get(Isolate);
     v8::Context::Scope ContextScope(Context);
-    for (int i = 0; i < PendingToRemove.size(); ++i)
+
+    for (void* DelegatePtr : Delegates)
     {
-        ClearDelegate(Isolate, Context, PendingToRemove[i]);
-        if (!DelegateMap[PendingToRemove[i]].PassByPointer)
+        auto Iter = DelegateMap.find(DelegatePtr);
+        // 非传指针的delegate是new出来的，地址可能已被别的owner复用
+        if (Iter == DelegateMap.end() || Iter->second.OwnerObject != Owner)
         {
-            delete ((FScriptDelegate *)PendingToRemove[i]);
+            continue;
         }
-        DelegateMap.erase(PendingToRemove[i]);
+        // owner正在析构，delegate成员可能已经析构，ClearDelegate里不能再去清它
+        Iter->second.Owner.Reset();
+        FV8Utils::SetPointer(Isolate, Iter->second.JSObject.Get(Isolate), nullptr, 0);
+        const bool PassByPointer = Iter->second.PassByPointer;
+        // ClearDelegate之后不再使用Iter
+        ClearDelegate(Isolate, Context, DelegatePtr);
+        if (!PassByPointer)
+        {
+            delete ((FScriptDelegate *)DelegatePtr);
+        }
+        DelegateMap.erase(DelegatePtr);
     }
-    return true;
 }
 
 FPropertyTranslator* FJsEnvImpl::GetContainerPropertyTranslator(PropertyMacro* Property)
@@ -1686,7 +2184,7 @@ v8::Local<v8::Value> FJsEnvImpl::FindOrAddContainer(v8::Isolate* Isolate, v8::Lo
     if (!PassByPointer)
     {
         auto Iter = StructMap.find(Ptr);
-        if (Iter != StructMap.end())
+        if (Iter != StructMap.end() && !Iter->second.IsEmpty())
         {
             return v8::Local<v8::Value>::New(Isolate, Iter->second);
         }
@@ -1717,35 +2215,35 @@ v8::Local<v8::Value> FJsEnvImpl::FindOrAddContainer(v8::Isolate* Isolate, v8::Lo
 
 void FJsEnvImpl::BindStruct(UScriptStruct* ScriptStruct, void *Ptr, v8::Local<v8::Object> JSObject, bool PassByPointer)
 {
+    FinalizeCollectedWrappers();
     FV8Utils::SetPointer(MainIsolate, JSObject, Ptr, 0);
     FV8Utils::SetPointer(MainIsolate, JSObject, ScriptStruct, 1);// add type info
         
     if (!PassByPointer)
     {
-        StructMap[Ptr] = v8::UniquePersistent<v8::Value>(MainIsolate, JSObject);
+        auto& Handle = StructMap[Ptr];
+        Handle = v8::UniquePersistent<v8::Value>(MainIsolate, JSObject);
+        Handle.SetWeak<void>(ScriptStruct, OnWrapperGarbageCollected<ECollectedWrapper::Struct>, v8::WeakCallbackType::kInternalFields);
         ScriptStructTypeMap[Ptr] = ScriptStruct;
-        StructMap[Ptr].SetWeak<UScriptStruct>(ScriptStruct, FScriptStructWrapper::OnGarbageCollectedWithFree, v8::WeakCallbackType::kInternalFields);
     }
-}
-
-static void CDataGarbageCollectedWithFree(const v8::WeakCallbackInfo<JSClassDefinition>& Data)
-{
-    JSClassDefinition *ClassDefinition = Data.GetParameter();
-    void *Ptr = DataTransfer::MakeAddressWithHighPartOfTwo(Data.GetInternalField(0), Data.GetInternalField(1));
-    if (ClassDefinition->Finalize) ClassDefinition->Finalize(Ptr);
-    FV8Utils::IsolateData<IObjectMapper>(Data.GetIsolate())->UnBindCData(ClassDefinition, Ptr);
+    else
+    {
+        TrackFrameObject(Ptr, JSObject);
+    }
 }
 
 void FJsEnvImpl::BindCData(JSClassDefinition* ClassDefinition, void *Ptr, v8::Local<v8::Object> JSObject, bool PassByPointer)
 {
+    FinalizeCollectedWrappers();
     FV8Utils::SetPointer(MainIsolate, JSObject, Ptr, 0);
     FV8Utils::SetPointer(MainIsolate, JSObject, const_cast<char*>(ClassDefinition->CDataName), 1);
 
     if(!PassByPointer)//指针传递不用处理GC
     {
-        CDataMap[Ptr] = v8::UniquePersistent<v8::Value>(MainIsolate, JSObject);
+        auto& Handle = CDataMap[Ptr];
+        Handle = v8::UniquePersistent<v8::Value>(MainIsolate, JSObject);
+        Handle.SetWeak<void>(ClassDefinition, OnWrapperGarbageCollected<ECollectedWrapper::CData>, v8::WeakCallbackType::kInternalFields);
         CDataFinalizeMap[Ptr] = ClassDefinition->Finalize;
-        CDataMap[Ptr].SetWeak<JSClassDefinition>(ClassDefinition, CDataGarbageCollectedWithFree, v8::WeakCallbackType::kInternalFields);
     }
 }
 
@@ -1761,11 +2259,13 @@ void FJsEnvImpl::UnBindCData(JSClassDefinition* ClassDefinition, void *Ptr)
     CDataMap.erase(Ptr);
 }
 
-void FJsEnvImpl::BindContainer(void* Ptr, v8::Local<v8::Object> JSObject, void(*Callback)(const v8::WeakCallbackInfo<void>& data))
+void FJsEnvImpl::BindContainer(void* Ptr, v8::Local<v8::Object> JSObject, void(*Finalize)(void* Ptr))
 {
+    FinalizeCollectedWrappers();
     FV8Utils::SetPointer(MainIsolate, JSObject, Ptr, 0);
-    StructMap[Ptr] = v8::UniquePersistent<v8::Value>(MainIsolate, JSObject);
-    StructMap[Ptr].SetWeak<void>(nullptr, Callback, v8::WeakCallbackType::kInternalFields);
+    auto& Handle = StructMap[Ptr];
+    Handle = v8::UniquePersistent<v8::Value>(MainIsolate, JSObject);
+    Handle.SetWeak<void>(reinterpret_cast<void*>(Finalize), OnWrapperGarbageCollected<ECollectedWrapper::Container>, v8::WeakCallbackType::kInternalFields);
 }
 
 void FJsEnvImpl::UnBindContainer(void* Ptr)
@@ -1773,6 +2273,107 @@ void FJsEnvImpl::UnBindContainer(void* Ptr)
     StructMap.erase(Ptr);
 }
 
+void FJsEnvImpl::OnWrapperCollected(ECollectedWrapper Kind, void* Ptr, void* Type)
+{
+    // v8要求在第一遍弱回调里Reset句柄；这里只查找不增删，各个Map的结构不变
+    FCollectedWrapper Collected = { Kind, Ptr, Type, INDEX_NONE };
+    v8::UniquePersistent<v8::Value>* Handle = nullptr;
+    if (Kind == ECollectedWrapper::Object)
+    {
+        Handle = FindObjectHandle(static_cast<UObject*>(Ptr));
+#if defined(OBJECT_MAP_BY_INDEX)
+        Collected.ObjectIndex = GUObjectArray.ObjectToIndex(static_cast<UObject*>(Ptr));
+#endif
+    }
+    else
+    {
+        auto& Map = Kind == ECollectedWrapper::CData ? CDataMap : StructMap;
+        auto Iter = Map.find(Ptr);
+        Handle = Iter == Map.end() ? nullptr : &Iter->second;
+    }
+    if (Handle)
+    {
+        Handle->Reset();
+    }
+    CollectedWrappers.push_back(Collected);
+}
+
+void FJsEnvImpl::FinalizeCollectedWrappers()
+{
+    if (CollectedWrappers.empty())
+    {
+        return;
+    }
+    // 处理期间新回收的（比如Finalize里触发了GC）留到下一次
+    std::vector<FCollectedWrapper> Batch;
+    Batch.swap(CollectedWrappers);
+    for (const auto& Collected : Batch)
+    {
+        void* Ptr = Collected.Ptr;
+        // 回收后已经被重新绑定（句柄不为空）或者主动解绑（查不到）的跳过
+        switch (Collected.Kind)
+        {
+        case ECollectedWrapper::Object:
+        {
+            // 对象可能在回收后已经销毁，不能再解引用
+#if defined(OBJECT_MAP_BY_INDEX)
+            if (Collected.ObjectIndex >= 0 && Collected.ObjectIndex < static_cast<int32>(ObjectMap.size()) && ObjectMap[Collected.ObjectIndex].IsEmpty())
+            {
+                UserObjectRetainer.Release(static_cast<UObject*>(Ptr));
+            }
+#else
+            auto Iter = ObjectMap.find(static_cast<UObject*>(Ptr));
+            if (Iter != ObjectMap.end() && Iter->second.IsEmpty())
+            {
+                ObjectMap.erase(Iter);
+                UserObjectRetainer.Release(static_cast<UObject*>(Ptr));
+            }
+#endif
+            break;
+        }
+        case ECollectedWrapper::Struct:
+        {
+            auto Iter = StructMap.find(Ptr);
+            if (Iter != StructMap.end() && Iter->second.IsEmpty())
+            {
+                UnBindStruct(static_cast<UScriptStruct*>(Collected.Type), Ptr);
+                FScriptStructWrapper::Free(static_cast<UScriptStruct*>(Collected.Type), Ptr);
+            }
+            break;
+        }
+        case ECollectedWrapper::Container:
+        {
+            auto Iter = StructMap.find(Ptr);
+            if (Iter != StructMap.end() && Iter->second.IsEmpty())
+            {
+                UnBindContainer(Ptr);
+                if (Collected.Type)
+                {
+                    reinterpret_cast<void(*)(void*)>(Collected.Type)(Ptr);
+                }
+            }
+            break;
+        }
+        case ECollectedWrapper::CData:
+        {
+            auto Iter = CDataMap.find(Ptr);
+            if (Iter != CDataMap.end() && Iter->second.IsEmpty())
+            {
+                JSClassDefinition* ClassDefinition = static_cast<JSClassDefinition*>(Collected.Type);
+                if (ClassDefinition->Finalize) ClassDefinition->Finalize(Ptr);
+                UnBindCData(ClassDefinition, Ptr);
+            }
+            break;
+        }
+        }
+    }
+    if (CollectedWrappers.empty())
+    {
+        Batch.clear();
+        Batch.swap(CollectedWrappers);  // 复用容量
+    }
+}
+
 v8::Local<v8::FunctionTemplate> FJsEnvImpl::GetTemplateOfClass(UStruct *InStruct, bool &Existed)
 {
     auto Isolate = MainIsolate;
@@ -1833,6 +2434,7 @@ v8::Local<v8::FunctionTemplate> FJsEnvImpl::GetTemplateOfClass(UStruct *InStruct
         }
             
         ClassToTemplateMap[InStruct] = v8::UniquePersistent<v8::FunctionTemplate>(Isolate, Template);
+        MarkJsKnownObject(InStruct);
 
         Existed = false;
         return HandleScope.Escape(Template);
@@ -2615,6 +3217,7 @@ void FJsEnvImpl::MakeUClass(const v8::FunctionCallbackInfo<v8::Value>& Info)
     if (!GeneratedClasses.Contains(Class))
     {
         GeneratedClasses.Add(Class);
+        MarkJsKnownObject(Class);
     }
     SysObjectRetainer.Retain(Class);
 
@@ -2750,6 +3353,25 @@ void FJsEnvImpl::DumpStatisticsLog(const v8::FunctionCallbackInfo<v8::Value> &In
 
     Logger->Info(StatisticsLog);
 #endif // !WITH_QUICKJS
+
+    const FStructMemoryPool::FStatistics& PoolStatistics = FStructMemoryPool::Get().GetStatistics();
+    Logger->Info(FString::Printf(TEXT(
+        "------------------------\n"
+        "Dump Statistics of Struct Memory Pool:\n"
+        "alloc_count: %llu\n"
+        "free_count: %llu\n"
+        "reuse_count: %llu\n"
+        "unpooled_count: %llu\n"
+        "slab_bytes: %llu\n"
+        "------------------------\n"),
+        PoolStatistics.AllocCount,
+        PoolStatistics.FreeCount,
+        PoolStatistics.ReuseCount,
+        PoolStatistics.UnpooledCount,
+        PoolStatistics.SlabBytes
+    ));
+
+    Logger->Info(FString::Printf(TEXT("live_delegate_proxys: %d"), GetLiveDelegateProxyCount()));
 }
 }
 
@@ -17,6 +17,8 @@
 #include "TickerDelegateWrapper.h"
 #include "TypeScriptGeneratedClass.h"
 #include "ContainerMeta.h"
+#include "PointerHashMap.h"
+#include "ParamsBufferArena.h"
 
 #pragma warning(push, 0)  
 #include "libplatform/libplatform.h"
@@ -51,6 +53,8 @@ public:
 
     void LowMemoryNotification() override;
 
+    void SetGCSettings(const FJsEnvGCSettings& Settings) override;
+
     void WaitDebugger(double timeout) override
     {
         const auto startTime = FDateTime::Now();
@@ -86,6 +90,8 @@ public:
 
     void UnBind(UClass *Class, UObject *UEObject, bool ResetPointer);
 
+    v8::UniquePersistent<v8::Value>* FindObjectHandle(UObject *UEObject);
+
     v8::Local<v8::Value> FindOrAdd(v8::Isolate* InIsolate, v8::Local<v8::Context>& Context, UClass *Class, UObject *UEObject) override;
 
     void BindStruct(UScriptStruct* ScriptStruct, void *Ptr, v8::Local<v8::Object> JSObject, bool PassByPointer) override;
@@ -102,7 +108,7 @@ public:
 
     void Merge(v8::Isolate* Isolate, v8::Local<v8::Context> Context, v8::Local<v8::Object> Src, UStruct* DesType, void* Des) override;
 
-    void BindContainer(void* Ptr, v8::Local<v8::Object> JSObject, void(*Callback)(const v8::WeakCallbackInfo<void>& data)) override;
+    void BindContainer(void* Ptr, v8::Local<v8::Object> JSObject, void(*Finalize)(void* Ptr)) override;
 
     void UnBindContainer(void* Ptr) override;
 
@@ -122,6 +128,16 @@ public:
 
     void ReleaseManualReleaseDelegate(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
+    void BatchCall(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    void MathStructTypedArrayScope(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    void FrameScope(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    v8::Local<v8::Value> TryAddFrameStruct(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, UScriptStruct* ScriptStruct, const void* ValuePtr) override;
+
+    bool IsFrameStructMemory(const void* Ptr) override;
+
     bool RemoveFromDelegate(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, void *DelegatePtr, v8::Local<v8::Function> JsFunction) override;
 
     bool ClearDelegate(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, void *DelegatePtr) override;
@@ -132,7 +148,23 @@ public:
 
     bool IsInstanceOf(const char* CDataName, v8::Local<v8::Object> JsObject) override;
 
-    bool CheckDelegateProxys(float tick);
+    int32 GetMathStructTypedArrayMode() override { return MathStructTypedArrayMode; }
+
+    void SetMathStructTypedArrayMode(int32 Mode) override { MathStructTypedArrayMode = Mode; }
+
+    v8::Local<v8::String> NameToString(v8::Isolate* Isolate, const FName& Name) override;
+
+    FName StringToName(v8::Isolate* Isolate, v8::Local<v8::Value> Value) override;
+
+    int32 GetLiveDelegateProxyCount() const { return static_cast<int32>(DelegateProxys.size()); }
+
+    bool TickFinalize(float tick);
+
+    void FinalizeCollectedWrappers();
+
+    bool TickGC(float tick);
+
+    void OnPreGarbageCollect();
 
     v8::Local<v8::Value> CreateArray(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, FPropertyTranslator* Property, void* ArrayPtr) override;
 
@@ -167,6 +199,18 @@ public:
     void TryReleaseType(UStruct *Struct);
 
 private:
+    // 标记js接触过的UObject，NotifyUObjectDeleted靠它跳过无关对象，所以往下面以UObject为key的表里加东西时都要调用
+    void MarkJsKnownObject(const class UObjectBase *Object);
+
+    UDynamicDelegateProxy* NewDelegateProxy(v8::Isolate* Isolate, UFunction* SignatureFunction, v8::Local<v8::Function> JsFunction);
+
+    void ReleaseDelegateProxy(UDynamicDelegateProxy* DelegateProxy);
+
+    void UnlinkDelegateOwner(const class UObjectBase* Owner, void* DelegatePtr);
+
+    // owner销毁时调用，不会再访问delegate所在的内存
+    void RemoveOwnedDelegates(const class UObjectBase* Owner);
+
     FString GetExecutionException(v8::Isolate* Isolate, v8::TryCatch* TryCatch);
 
     bool LoadFile(const FString& RequiringDir, const FString& ModuleName, FString& OutPath, FString& OutDebugPath, TArray<uint8>& Data, FString &ErrInfo);
@@ -231,7 +275,15 @@ private:
 
     struct ObjectMerger
     {
-        std::map<std::string, std::unique_ptr<FPropertyTranslator>> Fields;
+        // 字段名在构建时就转成internalized字符串，按hash链起来；对象字面量的key也是internalized的，StrictEquals只需比较指针
+        struct FField
+        {
+            v8::Global<v8::String> Name;
+            std::unique_ptr<FPropertyTranslator> Translator;
+            int32 NextSameHash;
+        };
+        std::vector<FField> Fields;
+        TMap<int32, int32> FieldIndexByHash;
         UStruct *Struct;
         FJsEnvImpl* Parent;
 
@@ -239,14 +291,46 @@ private:
         {
             Parent = InParent;
             Struct = InStruct;
+            v8::Isolate* Isolate = Parent->MainIsolate;
+            v8::HandleScope HandleScope(Isolate);
             for (TFieldIterator<PropertyMacro> It(Struct); It; ++It)
             {
                 PropertyMacro *Property = *It;
-                TStringConversion<TStringConvert<TCHAR, ANSICHAR>> Name(*Property->GetName());
-                Fields[Name.Get()] = FPropertyTranslator::Create(Property);
+                auto Name = v8::String::NewFromUtf8(Isolate, TCHAR_TO_UTF8(*Property->GetName()), v8::NewStringType::kInternalized).ToLocalChecked();
+                const int32 Hash = KeyHash(Isolate, Name);
+                int32& Head = FieldIndexByHash.FindOrAdd(Hash, INDEX_NONE);
+                Fields.push_back({ v8::Global<v8::String>(Isolate, Name), FPropertyTranslator::Create(Property), Head });
+                Head = static_cast<int32>(Fields.size()) - 1;
             }
         }
 
+        FORCEINLINE static int32 KeyHash(v8::Isolate* Isolate, v8::Local<v8::String> Key)
+        {
+#ifndef WITH_QUICKJS
+            return Key->GetIdentityHash();
+#else
+            return static_cast<int32>(GetTypeHash(FV8Utils::ToFString(Isolate, Key)));
+#endif
+        }
+
+        FORCEINLINE FPropertyTranslator* FindField(v8::Isolate* Isolate, v8::Local<v8::Value> Key)
+        {
+            if (!Key->IsString())
+            {
+                return nullptr;
+            }
+            auto KeyString = Key.As<v8::String>();
+            const int32* Head = FieldIndexByHash.Find(KeyHash(Isolate, KeyString));
+            for (int32 Index = Head ? *Head : INDEX_NONE; Index != INDEX_NONE; Index = Fields[Index].NextSameHash)
+            {
+                if (Fields[Index].Name.Get(Isolate)->StrictEquals(KeyString))
+                {
+                    return Fields[Index].Translator.get();
+                }
+            }
+            return nullptr;
+        }
+
         void Merge(v8::Isolate* Isolate, v8::Local<v8::Context> Context, v8::Local<v8::Object> JsObject, void* Ptr)
         {
             if (auto Class = Cast<UClass>(Struct))
@@ -261,8 +345,8 @@ private:
             for (decltype(Keys->Length()) i = 0; i < Keys->Length(); ++i)
             {
                 auto Key = Keys->Get(Context, i).ToLocalChecked();
-                auto Iter = Fields.find(*v8::String::Utf8Value(Isolate, Key));
-                if (Iter != Fields.end())
+                auto Translator = FindField(Isolate, Key);
+                if (Translator)
                 {
                     auto MaybeValue = JsObject->Get(Context, Key);
                     if (!MaybeValue.IsEmpty())
@@ -274,22 +358,22 @@ private:
                             if (!FV8Utils::GetPoninterFast<void>(JsObjectField))
                             {
                                 UStruct *FieldStruct = nullptr;
-                                if (auto ObjectPropertyBase = CastFieldMacro<ObjectPropertyBaseMacro>(Iter->second->Property))
+                                if (auto ObjectPropertyBase = CastFieldMacro<ObjectPropertyBaseMacro>(Translator->Property))
                                 {
                                     FieldStruct = ObjectPropertyBase->PropertyClass;
                                 }
-                                else if (auto StructProperty = CastFieldMacro<StructPropertyMacro>(Iter->second->Property))
+                                else if (auto StructProperty = CastFieldMacro<StructPropertyMacro>(Translator->Property))
                                 {
                                     FieldStruct = StructProperty->Struct;
                                 }
                                 if (FieldStruct)
                                 {
-                                    Parent->GetObjectMerger(FieldStruct)->Merge(Isolate, Context, JsObjectField, Iter->second->Property->ContainerPtrToValuePtr<void>(Ptr));
+                                    Parent->GetObjectMerger(FieldStruct)->Merge(Isolate, Context, JsObjectField, Translator->Property->ContainerPtrToValuePtr<void>(Ptr));
                                 }
                                 continue;
                             }
                         }
-                        if (!Value->IsUndefined())Iter->second->JsToUEInContainer(Isolate, Context, Value, Ptr, true);
+                        if (!Value->IsUndefined())Translator->JsToUEInContainer(Isolate, Context, Value, Ptr, true);
                     }
                 }
             }
@@ -347,20 +431,52 @@ private:
 
     v8::Global<v8::Function> ReloadJs;
 
-    std::map<UStruct*, v8::UniquePersistent<v8::FunctionTemplate>> ClassToTemplateMap;
+    TPointerHashMap<UStruct*, v8::UniquePersistent<v8::FunctionTemplate>> ClassToTemplateMap;
 
     std::map<const void*, v8::UniquePersistent<v8::FunctionTemplate>> CDataNameToTemplateMap;
 
     std::map<UStruct*, std::pair<std::unique_ptr<FStructWrapper>, int>> TypeReflectionMap;
 
-    std::map<UObject*, v8::UniquePersistent<v8::Value> > ObjectMap;
-    std::map<const class UObjectBase*, v8::UniquePersistent<v8::Value> > GeneratedObjectMap;
+#if defined(OBJECT_MAP_BY_INDEX)
+    // 下标为UObject在GUObjectArray中的InternalIndex，对象销毁时在NotifyUObjectDeleted里清掉，下标复用前一定已经清理
+    std::vector<v8::UniquePersistent<v8::Value> > ObjectMap;
+#else
+    TPointerHashMap<UObject*, v8::UniquePersistent<v8::Value> > ObjectMap;
+#endif
+    TPointerHashMap<const class UObjectBase*, v8::UniquePersistent<v8::Value> > GeneratedObjectMap;
+
+    TPointerHashMap<void*, v8::UniquePersistent<v8::Value> > StructMap;
+    TPointerHashMap<void*, v8::UniquePersistent<v8::Value> > CDataMap;
+
+    enum class ECollectedWrapper : uint8
+    {
+        Object,     // Type: UClass
+        Struct,     // Type: UScriptStruct
+        Container,  // Type: 释放函数，传指针时为空
+        CData,      // Type: JSClassDefinition
+    };
+
+    struct FCollectedWrapper
+    {
+        ECollectedWrapper Kind;
+        void* Ptr;
+        void* Type;
+        int32 ObjectIndex;  // 只在OBJECT_MAP_BY_INDEX时使用
+    };
+
+    // 弱回调里只Reset句柄并记到这里，解绑和释放C++侧资源在tick或下一次Bind*时做，GC过程中不改动各个Map
+    std::vector<FCollectedWrapper> CollectedWrappers;
 
-    std::map<void*, v8::UniquePersistent<v8::Value> > StructMap;
-    std::map<void*, v8::UniquePersistent<v8::Value> > CDataMap;
+    void OnWrapperCollected(ECollectedWrapper Kind, void* Ptr, void* Type);
 
-    std::map<void*, FinalizeFunc > CDataFinalizeMap;
-    std::map<void*, TWeakObjectPtr<UScriptStruct>> ScriptStructTypeMap;
+    template<ECollectedWrapper Kind>
+    static void OnWrapperGarbageCollected(const v8::WeakCallbackInfo<void>& Data)
+    {
+        Get(Data.GetIsolate())->OnWrapperCollected(Kind, DataTransfer::MakeAddressWithHighPartOfTwo(Data.GetInternalField(0), Data.GetInternalField(1)), Data.GetParameter());
+    }
+
+    TPointerHashMap<void*, FinalizeFunc > CDataFinalizeMap;
+    TPointerHashMap<void*, TWeakObjectPtr<UScriptStruct>> ScriptStructTypeMap;
 
     v8::UniquePersistent<v8::FunctionTemplate> ArrayTemplate;
 
@@ -376,12 +492,16 @@ private:
 
     std::map<UFunction*, std::unique_ptr<FFunctionTranslator>> JsCallbackPrototypeMap;
 
+    // batchCall的目标UFunction可能随蓝图重编译、热重载销毁，销毁时在NotifyUObjectDeleted里清掉，防止地址复用命中旧的translator
+    std::map<UFunction*, std::unique_ptr<FFunctionTranslator>> BatchCallTranslatorMap;
+
     std::map<UStruct *, std::unique_ptr<ObjectMerger>> ObjectMergers;
 
     struct DelegateObjectInfo
     {
         v8::UniquePersistent<v8::Object> JSObject;//function to proxy save here
         TWeakObjectPtr<UObject> Owner;//可用于自动清理
+        const class UObjectBase* OwnerObject;//只用于在DelegateOwnerMap中反查，不能解引用
         DelegatePropertyMacro *DelegateProperty;
         MulticastDelegatePropertyMacro *MulticastDelegateProperty;
         UFunction *SignatureFunction;
@@ -439,7 +559,7 @@ private:
 
     v8::UniquePersistent<v8::FunctionTemplate> MulticastDelegateTemplate;
 
-    std::map<void*, DelegateObjectInfo> DelegateMap;
+    TPointerHashMap<void*, DelegateObjectInfo> DelegateMap;
 
     std::map<UFunction*, TsFunctionInfo> TsFunctionMap;
 
@@ -449,7 +569,31 @@ private:
 
     std::map<FDelegateHandle*, FTickerDelegateWrapper*> TickerDelegateHandleMap;
 
-    FDelegateHandle DelegateProxysCheckerHandler;
+    // 以owner为key，owner销毁时在NotifyUObjectDeleted里清理它上面的delegate，不再定时扫描DelegateMap
+    TPointerHashMap<const class UObjectBase*, std::vector<void*> > DelegateOwnerMap;
+
+    // 所有未释放的UDynamicDelegateProxy，删除时用最后一个元素填洞保持紧凑，下标记在ProxyIndex
+    std::vector<TWeakObjectPtr<UDynamicDelegateProxy> > DelegateProxys;
+
+    // 下标为GUObjectArray中的InternalIndex
+    TBitArray<> JsKnownObjects;
+
+    FDelegateHandle FinalizeTickerHandler;
+
+    FJsEnvGCSettings GCSettings;
+
+    FDelegateHandle GCTickerHandler;
+
+    FDelegateHandle PreGarbageCollectHandler;
+
+#ifndef WITH_QUICKJS
+    // 用于IdleNotificationDeadline的时间基准，为空则不做idle gc
+    v8::Platform* V8Platform = nullptr;
+#endif
+
+    double HeapCheckElapsed = 0;
+
+    bool UnderMemoryPressure = false;
 
     V8Inspector* Inspector;
 
@@ -461,7 +605,48 @@ private:
 
     v8::Global<v8::Map> ManualReleaseCallbackMap;
 
-    std::vector<TWeakObjectPtr<UDynamicDelegateProxy>> ManualReleaseCallbackList;
+    int32 MathStructTypedArrayMode = 0;
+
+    struct FFrameStruct
+    {
+        UScriptStruct* ScriptStruct;
+        void* Ptr;
+    };
+
+    // 指向帧内存的js对象，帧struct本身以及从它上面取出的struct成员、定长数组成员
+    struct FFrameObject
+    {
+        FParamsBufferArena::FMark Position;
+        v8::Global<v8::Object> JSObject;
+    };
+
+    // puerts.frameScope嵌套层数，大于0时按值传到js的struct走帧内存
+    int32 FrameScopeDepth = 0;
+
+    // 不能和参数buffer共用线程单例，参数buffer的作用域会在frameScope内部结束
+    FParamsBufferArena FrameStructArena;
+
+    std::vector<FFrameStruct> FrameStructs;
+
+    // 所在内存被哪层frameScope归还就由哪层置空，外层帧struct的成员在内层取出也留给外层
+    std::vector<FFrameObject> FrameObjects;
+
+    void TrackFrameObject(const void* Ptr, v8::Local<v8::Object> JSObject);
+
+#ifndef WITH_QUICKJS
+    // FName和js字符串的双向缓存，直接映射，冲突了就覆盖；js字符串都是internalized的，同名FName返回同一个js字符串
+    static const int32 NAME_CACHE_SIZE = 1024;
+
+    struct FNameCacheEntry
+    {
+        FName Name;
+        v8::Global<v8::String> String;
+    };
+
+    FNameCacheEntry NameToStringCache[NAME_CACHE_SIZE];
+
+    FNameCacheEntry StringToNameCache[NAME_CACHE_SIZE];
+#endif
 };
 
 }
@@ -42,7 +42,8 @@ public:
 
     virtual void Merge(v8::Isolate* Isolate, v8::Local<v8::Context> Context, v8::Local<v8::Object> Src, UStruct* DesType, void* Des) = 0;
 
-    virtual void BindContainer(void* Ptr, v8::Local<v8::Object> JSObject, void(*Callback)(const v8::WeakCallbackInfo<void>& data)) = 0;
+    // Finalize为空表示容器内存不归js对象管理（传指针）
+    virtual void BindContainer(void* Ptr, v8::Local<v8::Object> JSObject, void(*Finalize)(void* Ptr)) = 0;
 
     virtual void UnBindContainer(void* Ptr) = 0;
 
@@ -69,5 +70,21 @@ public:
     virtual bool IsInstanceOf(UStruct *Struct, v8::Local<v8::Object> JsObject) = 0;
 
     virtual bool IsInstanceOf(const char* CDataName, v8::Local<v8::Object> JsObject) = 0;
+
+    // FVector/FRotator/FQuat/FTransform按值返回时的形式，0：包装对象，32：Float32Array，64：Float64Array
+    // 只在puerts.mathStructTypedArrayScope内非0，回调进js（CallJs）时临时切回0
+    virtual int32 GetMathStructTypedArrayMode() = 0;
+
+    virtual void SetMathStructTypedArrayMode(int32 Mode) = 0;
+
+    // 在puerts.frameScope内时，把按值传递的struct拷到帧内存上并返回包装对象（作用域结束即失效），否则返回空
+    virtual v8::Local<v8::Value> TryAddFrameStruct(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, UScriptStruct* ScriptStruct, const void* ValuePtr) = 0;
+
+    // Ptr是否在frameScope的帧内存上，帧struct里的容器、delegate成员不能按指针传给js
+    virtual bool IsFrameStructMemory(const void* Ptr) = 0;
+
+    virtual v8::Local<v8::String> NameToString(v8::Isolate* Isolate, const FName& Name) = 0;
+
+    virtual FName StringToName(v8::Isolate* Isolate, v8::Local<v8::Value> Value) = 0;
 };
 }
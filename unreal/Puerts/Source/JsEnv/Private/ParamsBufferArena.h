@@ -0,0 +1,149 @@
+/*
+* Tencent is pleased to support the open source community by making Puerts available.
+* Copyright (C) 2020 THL A29 Limited, a Tencent company.  All rights reserved.
+* Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may be subject to their corresponding license terms.
+* This file is subject to the terms and conditions defined in file 'LICENSE', which is part of this source code package.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSingleton.h"
+
+namespace puerts
+{
+// 每个线程一个的参数buffer栈，支持嵌套调用（UE调JS再调UE），按需增长，通过FParamsBufferScope在作用域结束时归还
+class FParamsBufferArena : public TThreadSingleton<FParamsBufferArena>
+{
+public:
+    static const uint32 BLOCK_SIZE = 16 * 1024;
+
+    static const uint32 ALIGNMENT = 16;
+
+    struct FMark
+    {
+        int32 Block;
+        uint32 Offset;
+    };
+
+    FParamsBufferArena() : Current(-1), Offset(0) {}
+
+    ~FParamsBufferArena()
+    {
+        for (auto& Block : Blocks)
+        {
+            FMemory::Free(Block.Data);
+        }
+    }
+
+    FORCEINLINE FMark GetMark() const
+    {
+        return { Current, Offset };
+    }
+
+    FORCEINLINE void Reset(const FMark& Mark)
+    {
+        Current = Mark.Block;
+        Offset = Mark.Offset;
+    }
+
+    // Ptr落在已分配出去的内存里时返回true，OutPosition可以和GetMark的结果比较先后
+    bool FindPosition(const void* Ptr, FMark& OutPosition) const
+    {
+        const uint8* BytePtr = static_cast<const uint8*>(Ptr);
+        for (int32 i = 0; i <= Current; ++i)
+        {
+            const FBlock& Block = Blocks[i];
+            if (BytePtr >= Block.Data && BytePtr < Block.Data + (i == Current ? Offset : Block.Used))
+            {
+                OutPosition = { i, static_cast<uint32>(BytePtr - Block.Data) };
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Position是不是在Mark之后分配的，即Reset(Mark)时会被归还
+    FORCEINLINE static bool IsAllocatedAfter(const FMark& Position, const FMark& Mark)
+    {
+        return Position.Block > Mark.Block || (Position.Block == Mark.Block && Position.Offset >= Mark.Offset);
+    }
+
+    void* Alloc(uint32 Size)
+    {
+        Size = Align(Size, ALIGNMENT);
+        if (Current < 0 || Offset + Size > Blocks[Current].Size)
+        {
+            // 已经分配出去的内存不能移动，所以只能换下一个块
+            if (Current >= 0)
+            {
+                Blocks[Current].Used = Offset;
+            }
+            ++Current;
+            Offset = 0;
+            if (Current == Blocks.Num() || Blocks[Current].Size < Size)
+            {
+                uint32 BlockSize = Size > BLOCK_SIZE ? Size : BLOCK_SIZE;
+                FBlock NewBlock = { static_cast<uint8*>(FMemory::Malloc(BlockSize, ALIGNMENT)), BlockSize, 0 };
+                if (Current == Blocks.Num())
+                {
+                    Blocks.Add(NewBlock);
+                }
+                else
+                {
+                    // 后面的块当前都没在用，直接替换掉太小的块
+                    FMemory::Free(Blocks[Current].Data);
+                    Blocks[Current] = NewBlock;
+                }
+            }
+        }
+        void* Ret = Blocks[Current].Data + Offset;
+        Offset += Size;
+        return Ret;
+    }
+
+private:
+    struct FBlock
+    {
+        uint8* Data;
+        uint32 Size;
+        uint32 Used;  // 切到下一个块时记录，块尾放不下而空着的部分不算已分配
+    };
+
+    TArray<FBlock> Blocks;
+
+    int32 Current;
+
+    uint32 Offset;
+};
+
+class FParamsBufferScope
+{
+public:
+    explicit FParamsBufferScope(uint32 Size) : Arena(FParamsBufferArena::Get()), Mark(Arena.GetMark())
+    {
+        Buffer = Size > 0 ? Arena.Alloc(Size) : nullptr;
+    }
+
+    ~FParamsBufferScope()
+    {
+        Arena.Reset(Mark);
+    }
+
+    FORCEINLINE void* GetBuffer() const
+    {
+        return Buffer;
+    }
+
+private:
+    FParamsBufferArena& Arena;
+
+    FParamsBufferArena::FMark Mark;
+
+    void* Buffer;
+
+    FParamsBufferScope(const FParamsBufferScope&) = delete;
+
+    FParamsBufferScope& operator=(const FParamsBufferScope&) = delete;
+};
+}
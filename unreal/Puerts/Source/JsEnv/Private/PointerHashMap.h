@@ -0,0 +1,242 @@
+/*
+* Tencent is pleased to support the open source community by making Puerts available.
+* Copyright (C) 2020 THL A29 Limited, a Tencent company.  All rights reserved.
+* Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may be subject to their corresponding license terms.
+* This file is subject to the terms and conditions defined in file 'LICENSE', which is part of this source code package.
+*/
+
+#pragma once
+
+#include <vector>
+#include <utility>
+
+#include "CoreMinimal.h"
+
+namespace puerts
+{
+// 以指针为key的开放寻址（线性探测）哈希表，接口和std::map的常用部分保持一致，方便替换
+// erase只留墓碑不挪动元素，和std::map一样不影响其它元素的迭代器、引用，可以边遍历边erase
+// 和std::map不同的是：新增key（operator[]插入）可能rehash，会让这个map上所有的迭代器、引用（auto& X = Map[Key]）失效，
+// 所以持有迭代器或引用期间不能往同一个map里加新key，否则要重新find；operator[]访问已有的key不会rehash
+template<typename K, typename V>
+class TPointerHashMap
+{
+public:
+    struct FSlot
+    {
+        K first;
+        V second;
+    };
+
+    template<typename TSlot>
+    class TIterator
+    {
+    public:
+        TIterator(TSlot* InSlot, TSlot* InEnd) : Slot(InSlot), End(InEnd)
+        {
+            SkipEmpty();
+        }
+
+        FORCEINLINE TSlot& operator*() const { return *Slot; }
+
+        FORCEINLINE TSlot* operator->() const { return Slot; }
+
+        FORCEINLINE TIterator& operator++()
+        {
+            ++Slot;
+            SkipEmpty();
+            return *this;
+        }
+
+        FORCEINLINE TIterator operator++(int)
+        {
+            TIterator Ret = *this;
+            ++(*this);
+            return Ret;
+        }
+
+        FORCEINLINE bool operator==(const TIterator& Other) const { return Slot == Other.Slot; }
+
+        FORCEINLINE bool operator!=(const TIterator& Other) const { return Slot != Other.Slot; }
+
+    private:
+        FORCEINLINE void SkipEmpty()
+        {
+            while (Slot != End && (Slot->first == EmptyKey() || Slot->first == TombstoneKey()))
+            {
+                ++Slot;
+            }
+        }
+
+        TSlot* Slot;
+
+        TSlot* End;
+
+        friend class TPointerHashMap;
+    };
+
+    typedef TIterator<FSlot> iterator;
+
+    typedef TIterator<const FSlot> const_iterator;
+
+    TPointerHashMap() : Count(0), Tombstones(0) {}
+
+    TPointerHashMap(const TPointerHashMap&) = delete;
+
+    TPointerHashMap& operator=(const TPointerHashMap&) = delete;
+
+    FORCEINLINE iterator begin() { return iterator(Slots.data(), Slots.data() + Slots.size()); }
+
+    FORCEINLINE iterator end() { return iterator(Slots.data() + Slots.size(), Slots.data() + Slots.size()); }
+
+    FORCEINLINE const_iterator begin() const { return const_iterator(Slots.data(), Slots.data() + Slots.size()); }
+
+    FORCEINLINE const_iterator end() const { return const_iterator(Slots.data() + Slots.size(), Slots.data() + Slots.size()); }
+
+    FORCEINLINE size_t size() const { return Count; }
+
+    FORCEINLINE bool empty() const { return Count == 0; }
+
+    iterator find(K Key)
+    {
+        if (Count == 0)
+        {
+            return end();
+        }
+        size_t Index = FindIndex(Key);
+        return Slots[Index].first == Key ? iterator(Slots.data() + Index, Slots.data() + Slots.size()) : end();
+    }
+
+    V& operator[](K Key)
+    {
+        check(Key != EmptyKey() && Key != TombstoneKey());
+        if (Count > 0)
+        {
+            size_t Index = FindIndex(Key);
+            if (Slots[Index].first == Key)
+            {
+                return Slots[Index].second;
+            }
+        }
+        // 墓碑也占探测链，一起算负载；墓碑多时按原大小rehash清掉
+        if ((Count + Tombstones + 1) * 4 > Slots.size() * 3)
+        {
+            Rehash(Slots.empty() ? INITIAL_CAPACITY : ((Count + 1) * 2 > Slots.size() ? Slots.size() * 2 : Slots.size()));
+        }
+        size_t Index = FindInsertIndex(Key);
+        if (Slots[Index].first == TombstoneKey())
+        {
+            --Tombstones;
+        }
+        Slots[Index].first = Key;
+        ++Count;
+        return Slots[Index].second;
+    }
+
+    size_t erase(K Key)
+    {
+        if (Count == 0)
+        {
+            return 0;
+        }
+        size_t Index = FindIndex(Key);
+        if (Slots[Index].first != Key)
+        {
+            return 0;
+        }
+        EraseAt(Index);
+        return 1;
+    }
+
+    void erase(iterator Iter)
+    {
+        EraseAt(Iter.Slot - Slots.data());
+    }
+
+    void clear()
+    {
+        Slots.clear();
+        Count = 0;
+        Tombstones = 0;
+    }
+
+private:
+    static const size_t INITIAL_CAPACITY = 16;
+
+    FORCEINLINE static K EmptyKey()
+    {
+        return reinterpret_cast<K>(~static_cast<UPTRINT>(0));
+    }
+
+    // 和EmptyKey一样是不对齐的地址，不会和真实的指针冲突
+    FORCEINLINE static K TombstoneKey()
+    {
+        return reinterpret_cast<K>(~static_cast<UPTRINT>(1));
+    }
+
+    FORCEINLINE size_t Hash(K Key) const
+    {
+        // 对象地址低位基本都是对齐位，乘一个奇数常量后取高位
+        uint64 H = static_cast<uint64>(reinterpret_cast<UPTRINT>(Key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(H >> 32) & (Slots.size() - 1);
+    }
+
+    // 返回Key所在的位置，不存在则返回探测链结尾的空位，跳过墓碑
+    FORCEINLINE size_t FindIndex(K Key) const
+    {
+        const size_t Mask = Slots.size() - 1;
+        size_t Index = Hash(Key);
+        while (Slots[Index].first != Key && Slots[Index].first != EmptyKey())
+        {
+            Index = (Index + 1) & Mask;
+        }
+        return Index;
+    }
+
+    // 已确定Key不存在，返回探测链上第一个墓碑或空位
+    FORCEINLINE size_t FindInsertIndex(K Key) const
+    {
+        const size_t Mask = Slots.size() - 1;
+        size_t Index = Hash(Key);
+        while (Slots[Index].first != EmptyKey() && Slots[Index].first != TombstoneKey())
+        {
+            Index = (Index + 1) & Mask;
+        }
+        return Index;
+    }
+
+    void EraseAt(size_t Index)
+    {
+        Slots[Index].first = TombstoneKey();
+        Slots[Index].second = V();
+        --Count;
+        ++Tombstones;
+    }
+
+    void Rehash(size_t NewCapacity)
+    {
+        std::vector<FSlot> OldSlots(NewCapacity);
+        OldSlots.swap(Slots);
+        for (auto& Slot : Slots)
+        {
+            Slot.first = EmptyKey();
+        }
+        for (auto& Slot : OldSlots)
+        {
+            if (Slot.first != EmptyKey() && Slot.first != TombstoneKey())
+            {
+                size_t Index = FindInsertIndex(Slot.first);
+                Slots[Index].first = Slot.first;
+                Slots[Index].second = std::move(Slot.second);
+            }
+        }
+        Tombstones = 0;
+    }
+
+    std::vector<FSlot> Slots;
+
+    size_t Count;
+
+    size_t Tombstones;
+};
+}
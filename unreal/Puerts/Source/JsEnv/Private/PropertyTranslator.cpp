@@ -47,7 +47,13 @@ void FPropertyTranslator::Getter(v8::Isolate* Isolate, v8::Local<v8::Context>& C
     }
     else
     {
-        Info.GetReturnValue().Set(UEToJsInContainer(Isolate, Context, FV8Utils::GetPoninter(Info.This()), true));
+        void* Ptr = FV8Utils::GetPoninter(Info.This());
+        if (!Ptr)
+        {
+            FV8Utils::ThrowException(Isolate, "access a released struct");
+            return;
+        }
+        Info.GetReturnValue().Set(UEToJsInContainer(Isolate, Context, Ptr, true));
     }
 }
 
@@ -82,7 +88,13 @@ void FPropertyTranslator::Setter(v8::Isolate* Isolate, v8::Local<v8::Context>& C
     }
     else
     {
-        JsToUEInContainer(Isolate, Context, Value, FV8Utils::GetPoninter(Info.This()), true);
+        void* Ptr = FV8Utils::GetPoninter(Info.This());
+        if (!Ptr)
+        {
+            FV8Utils::ThrowException(Isolate, "access a released struct");
+            return;
+        }
+        JsToUEInContainer(Isolate, Context, Value, Ptr, true);
     }
 }
 
@@ -111,7 +123,194 @@ void FPropertyTranslator::DelegateGetter(v8::Local<v8::Name> Property, const v8:
     Info.GetReturnValue().Set(FV8Utils::IsolateData<IObjectMapper>(Isolate)->FindOrAddDelegate(Isolate, Context, Object, PropertyTranslator->Property, DelegatePtr, true));
 }
 
-void  FPropertyTranslator::SetAccessor(v8::Isolate* Isolate, v8::Local<v8::FunctionTemplate> Template)
+// 常用基础类型属性的特化accessor：直接按偏移读写，不经过ContainerPtrToValuePtr和UEToJs/JsToUE的虚调用
+template<typename T>
+static FORCEINLINE uint8* GetFastAccessorContainer(FPropertyTranslator* This, const v8::PropertyCallbackInfo<T>& Info)
+{
+    if (This->OwnerIsClass)
+    {
+        UObject* Object = FV8Utils::GetUObject(Info.This());
+        if (!Object || FV8Utils::IsReleasedPtr(Object))
+        {
+            v8::Isolate* Isolate = Info.GetIsolate();
+            v8::HandleScope HandleScope(Isolate);
+            FV8Utils::ThrowException(Isolate, Object ? "access a invalid object" : "access a null object");
+            return nullptr;
+        }
+        return reinterpret_cast<uint8*>(Object);
+    }
+    uint8* Ptr = static_cast<uint8*>(FV8Utils::GetPoninter(Info.This()));
+    if (!Ptr)
+    {
+        // puerts.frameScope结束后的struct
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        FV8Utils::ThrowException(Isolate, "access a released struct");
+    }
+    return Ptr;
+}
+
+template<typename TAccessor>
+static void FastGetter(v8::Local<v8::Name> Property, const v8::PropertyCallbackInfo<v8::Value>& Info)
+{
+    FPropertyTranslator* This = reinterpret_cast<FPropertyTranslator*>((v8::Local<v8::External>::Cast(Info.Data()))->Value());
+    uint8* Container = GetFastAccessorContainer(This, Info);
+    if (Container)
+    {
+        TAccessor::Get(This, Container + This->Property->GetOffset_ForInternal(), Info);
+    }
+}
+
+template<typename TAccessor>
+static void FastSetter(v8::Local<v8::Name> Property, v8::Local<v8::Value> Value, const v8::PropertyCallbackInfo<void>& Info)
+{
+    FPropertyTranslator* This = reinterpret_cast<FPropertyTranslator*>((v8::Local<v8::External>::Cast(Info.Data()))->Value());
+    uint8* Container = GetFastAccessorContainer(This, Info);
+    if (Container)
+    {
+        TAccessor::Set(This, Container + This->Property->GetOffset_ForInternal(), Value, Info);
+    }
+}
+
+// int32, uint8（包括byte枚举）
+template<typename T, typename TJs>
+struct TIntegerAccessor
+{
+    static FORCEINLINE void Get(FPropertyTranslator* This, uint8* Ptr, const v8::PropertyCallbackInfo<v8::Value>& Info)
+    {
+        Info.GetReturnValue().Set(static_cast<TJs>(*reinterpret_cast<T*>(Ptr)));
+    }
+
+    static FORCEINLINE void Set(FPropertyTranslator* This, uint8* Ptr, v8::Local<v8::Value> Value, const v8::PropertyCallbackInfo<void>& Info)
+    {
+        if (Value->IsInt32())
+        {
+            *reinterpret_cast<T*>(Ptr) = static_cast<T>(Value.As<v8::Int32>()->Value());
+        }
+        else
+        {
+            v8::Isolate* Isolate = Info.GetIsolate();
+            v8::HandleScope HandleScope(Isolate);
+            *reinterpret_cast<T*>(Ptr) = static_cast<T>(Value->Int32Value(Isolate->GetCurrentContext()).ToChecked());
+        }
+    }
+};
+
+// float, double
+template<typename T>
+struct TFloatingPointAccessor
+{
+    static FORCEINLINE void Get(FPropertyTranslator* This, uint8* Ptr, const v8::PropertyCallbackInfo<v8::Value>& Info)
+    {
+        Info.GetReturnValue().Set(static_cast<double>(*reinterpret_cast<T*>(Ptr)));
+    }
+
+    static FORCEINLINE void Set(FPropertyTranslator* This, uint8* Ptr, v8::Local<v8::Value> Value, const v8::PropertyCallbackInfo<void>& Info)
+    {
+        if (Value->IsNumber())
+        {
+            *reinterpret_cast<T*>(Ptr) = static_cast<T>(Value.As<v8::Number>()->Value());
+        }
+        else
+        {
+            v8::Isolate* Isolate = Info.GetIsolate();
+            v8::HandleScope HandleScope(Isolate);
+            *reinterpret_cast<T*>(Ptr) = static_cast<T>(Value->NumberValue(Isolate->GetCurrentContext()).ToChecked());
+        }
+    }
+};
+
+// BoolProperty的GetPropertyValue/SetPropertyValue不是虚函数，已经处理了bitfield
+struct FBoolAccessor
+{
+    static FORCEINLINE void Get(FPropertyTranslator* This, uint8* Ptr, const v8::PropertyCallbackInfo<v8::Value>& Info)
+    {
+        Info.GetReturnValue().Set(This->BoolProperty->GetPropertyValue(Ptr));
+    }
+
+    static FORCEINLINE void Set(FPropertyTranslator* This, uint8* Ptr, v8::Local<v8::Value> Value, const v8::PropertyCallbackInfo<void>& Info)
+    {
+        This->BoolProperty->SetPropertyValue(Ptr, Value->BooleanValue(Info.GetIsolate()));
+    }
+};
+
+struct FObjectAccessor
+{
+    static FORCEINLINE void Get(FPropertyTranslator* This, uint8* Ptr, const v8::PropertyCallbackInfo<v8::Value>& Info)
+    {
+        UObject* UEObject = *reinterpret_cast<UObject**>(Ptr);
+        if (!UEObject || !UEObject->IsValidLowLevelFast() || UEObject->IsPendingKill())
+        {
+            Info.GetReturnValue().SetUndefined();
+            return;
+        }
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+        Info.GetReturnValue().Set(FV8Utils::IsolateData<IObjectMapper>(Isolate)->FindOrAdd(Isolate, Context, UEObject->GetClass(), UEObject));
+    }
+
+    static FORCEINLINE void Set(FPropertyTranslator* This, uint8* Ptr, v8::Local<v8::Value> Value, const v8::PropertyCallbackInfo<void>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+        auto Object = FV8Utils::GetUObject(Context, Value);
+        if (FV8Utils::IsReleasedPtr(Object))
+        {
+            FV8Utils::ThrowException(Isolate, "passing a invalid object");
+            return;
+        }
+        *reinterpret_cast<UObject**>(Ptr) = Object;
+    }
+};
+
+template<typename TAccessor>
+static FORCEINLINE void SelectFastAccessor(v8::AccessorNameGetterCallback& GetterCallback, v8::AccessorNameSetterCallback& SetterCallback)
+{
+    GetterCallback = FastGetter<TAccessor>;
+    SetterCallback = FastSetter<TAccessor>;
+}
+
+static bool GetFastAccessor(PropertyMacro* Property, v8::AccessorNameGetterCallback& GetterCallback, v8::AccessorNameSetterCallback& SetterCallback)
+{
+    if (Property->ArrayDim != 1)
+    {
+        return false;
+    }
+    if (Property->IsA<IntPropertyMacro>())
+    {
+        SelectFastAccessor<TIntegerAccessor<int32, int32_t>>(GetterCallback, SetterCallback);
+    }
+    else if (Property->IsA<BytePropertyMacro>()
+        || (Property->IsA<EnumPropertyMacro>() && static_cast<EnumPropertyMacro*>(Property)->GetUnderlyingProperty()->IsA<BytePropertyMacro>()))
+    {
+        SelectFastAccessor<TIntegerAccessor<uint8, uint32_t>>(GetterCallback, SetterCallback);
+    }
+    else if (Property->IsA<FloatPropertyMacro>())
+    {
+        SelectFastAccessor<TFloatingPointAccessor<float>>(GetterCallback, SetterCallback);
+    }
+    else if (Property->IsA<DoublePropertyMacro>())
+    {
+        SelectFastAccessor<TFloatingPointAccessor<double>>(GetterCallback, SetterCallback);
+    }
+    else if (Property->IsA<BoolPropertyMacro>())
+    {
+        SelectFastAccessor<FBoolAccessor>(GetterCallback, SetterCallback);
+    }
+    else if (Property->GetClass() == ObjectPropertyMacro::StaticClass()) // 子类（Class、Weak、Soft等）存储格式或语义不同，走通用路径
+    {
+        SelectFastAccessor<FObjectAccessor>(GetterCallback, SetterCallback);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+bool FPropertyTranslator::GetAccessorInfo(FString& Name, v8::AccessorNameGetterCallback& GetterCallback, v8::AccessorNameSetterCallback& SetterCallback, v8::PropertyAttribute& Attribute)
 {
     if (Property->IsA<DelegatePropertyMacro>()
         || Property->IsA<MulticastDelegatePropertyMacro>()
@@ -121,26 +320,61 @@ void  FPropertyTranslator::SetAccessor(v8::Isolate* Isolate, v8::Local<v8::Funct
 #endif
         )
     {
-        if (Property->GetOwnerStruct()->IsA<UClass>()) // only uobject support
+        if (!Property->GetOwnerStruct()->IsA<UClass>()) // only uobject support
         {
-            Template->PrototypeTemplate()->SetAccessor(FV8Utils::InternalString(Isolate, Property->GetName()), DelegateGetter, nullptr,
-                v8::External::New(Isolate, this), v8::DEFAULT, (v8::PropertyAttribute)(v8::DontDelete | v8::ReadOnly));
+            return false;
         }
+        Name = Property->GetName();
+        GetterCallback = DelegateGetter;
+        SetterCallback = nullptr;
+        Attribute = (v8::PropertyAttribute)(v8::DontDelete | v8::ReadOnly);
     }
     else
     {
+        GetterCallback = Getter;
+        SetterCallback = Setter;
+        GetFastAccessor(Property, GetterCallback, SetterCallback);
+
         auto OwnerStruct = Property->GetOwnerStruct();
-        Template->PrototypeTemplate()->SetAccessor(FV8Utils::InternalString(Isolate, OwnerStruct && OwnerStruct->IsA<UUserDefinedStruct>() ? 
+        Name = OwnerStruct && OwnerStruct->IsA<UUserDefinedStruct>() ? 
 #if ENGINE_MINOR_VERSION >= 23 || ENGINE_MAJOR_VERSION > 4
             Property->GetAuthoredName()
 #else
             Property->GetDisplayNameText().ToString()
 #endif
-            : Property->GetName()), Getter, Setter,
-            v8::External::New(Isolate, this), v8::DEFAULT, v8::DontDelete);
+            : Property->GetName();
+        Attribute = v8::DontDelete;
+    }
+    return true;
+}
+
+void  FPropertyTranslator::SetAccessor(v8::Isolate* Isolate, v8::Local<v8::FunctionTemplate> Template)
+{
+    FString Name;
+    v8::AccessorNameGetterCallback GetterCallback;
+    v8::AccessorNameSetterCallback SetterCallback;
+    v8::PropertyAttribute Attribute;
+    if (GetAccessorInfo(Name, GetterCallback, SetterCallback, Attribute))
+    {
+        Template->PrototypeTemplate()->SetAccessor(FV8Utils::InternalString(Isolate, Name), GetterCallback, SetterCallback,
+            v8::External::New(Isolate, this), v8::DEFAULT, Attribute);
     }
 }
 
+bool  FPropertyTranslator::SetAccessor(v8::Isolate* Isolate, v8::Local<v8::Context> Context, v8::Local<v8::Object> Prototype)
+{
+    FString Name;
+    v8::AccessorNameGetterCallback GetterCallback;
+    v8::AccessorNameSetterCallback SetterCallback;
+    v8::PropertyAttribute Attribute;
+    if (GetAccessorInfo(Name, GetterCallback, SetterCallback, Attribute))
+    {
+        return Prototype->SetAccessor(Context, FV8Utils::InternalString(Isolate, Name), GetterCallback, SetterCallback,
+            v8::External::New(Isolate, this), v8::DEFAULT, Attribute).FromMaybe(false);
+    }
+    return false;
+}
+
 class FInt32PropertyTranslator : public FPropertyTranslator
 {
 public:
@@ -278,6 +512,75 @@ public:
     
 //----------------------------string-----------------------------
 
+// TCHAR是UTF-16时，FString和v8的two byte字符串可以直接互相拷贝，不需要经过UTF-8转码
+#if !defined(WITH_QUICKJS) && !PLATFORM_TCHAR_IS_4_BYTES
+#define TWO_BYTE_STRING_TRANSFER 1
+
+// 超过这个长度的只读字符串（FText）放到v8堆外，避免大字符串在v8堆上分配和搬移
+static const int32 EXTERNAL_STRING_THRESHOLD = 1024;
+
+class FExternalTwoByteString : public v8::String::ExternalStringResource
+{
+public:
+    explicit FExternalTwoByteString(const FString& InString) : String(InString) {}
+
+    const uint16_t* data() const override
+    {
+        return reinterpret_cast<const uint16_t*>(*String);
+    }
+
+    size_t length() const override
+    {
+        return String.Len();
+    }
+
+private:
+    FString String;
+};
+
+static FORCEINLINE v8::Local<v8::String> TwoByteToV8String(v8::Isolate* Isolate, const FString& String)
+{
+    return v8::String::NewFromTwoByte(Isolate, reinterpret_cast<const uint16_t*>(*String), v8::NewStringType::kNormal, String.Len()).ToLocalChecked();
+}
+
+static FORCEINLINE v8::Local<v8::String> ExternalTwoByteToV8String(v8::Isolate* Isolate, const FString& String)
+{
+    if (String.Len() < EXTERNAL_STRING_THRESHOLD)
+    {
+        return TwoByteToV8String(Isolate, String);
+    }
+    // 失败时v8不接管Resource，需要自己释放
+    auto Resource = new FExternalTwoByteString(String);
+    v8::Local<v8::String> Result;
+    if (!v8::String::NewExternalTwoByte(Isolate, Resource).ToLocal(&Result))
+    {
+        delete Resource;
+        return TwoByteToV8String(Isolate, String);
+    }
+    return Result;
+}
+
+static FORCEINLINE FString TwoByteToFString(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::Local<v8::Value>& Value)
+{
+    v8::Local<v8::String> String;
+    if (!Value->ToString(Context).ToLocal(&String))
+    {
+        return FString();
+    }
+    FString Result;
+    const int Length = String->Length();
+    if (Length > 0)
+    {
+        // 直接写到预先分配好的buffer里，one byte字符串由v8负责扩展
+        TArray<TCHAR>& CharArray = Result.GetCharArray();
+        CharArray.SetNumUninitialized(Length + 1);
+        String->Write(Isolate, reinterpret_cast<uint16_t*>(CharArray.GetData()), 0, Length, v8::String::NO_NULL_TERMINATION);
+        CharArray[Length] = 0;
+    }
+    return Result;
+}
+#endif
+
 class FStringPropertyTranslator : public FPropertyWithDestructorReflection
 {
 public:
@@ -285,14 +588,22 @@ public:
 
     v8::Local<v8::Value> UEToJs(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const void *ValuePtr, bool PassByPointer) const override
     {
+#if defined(TWO_BYTE_STRING_TRANSFER)
+        return TwoByteToV8String(Isolate, StringProperty->GetPropertyValue(ValuePtr));
+#else
         return FV8Utils::ToV8String(Isolate, StringProperty->GetPropertyValue(ValuePtr));
+#endif
     }
 
     bool JsToUE(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::Local<v8::Value>& Value, void *ValuePtr, bool DeepCopy) const override
     {
+#if defined(TWO_BYTE_STRING_TRANSFER)
+        StringProperty->SetPropertyValue(ValuePtr, TwoByteToFString(Isolate, Context, Value));
+#else
         auto Str = FV8Utils::ToFString(Isolate, Value);
         //TCHAR* Str = (TCHAR*)(*(v8::String::Value(Isolate, Value)));
         StringProperty->SetPropertyValue(ValuePtr, Str);
+#endif
         return true;
     }
 };
@@ -304,12 +615,12 @@ public:
 
     v8::Local<v8::Value> UEToJs(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const void *ValuePtr, bool PassByPointer) const override
     {
-        return FV8Utils::ToV8String(Isolate, NameProperty->GetPropertyValue(ValuePtr));
+        return FV8Utils::IsolateData<IObjectMapper>(Isolate)->NameToString(Isolate, NameProperty->GetPropertyValue(ValuePtr));
     }
 
     bool JsToUE(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::Local<v8::Value>& Value, void *ValuePtr, bool DeepCopy) const override
     {
-        NameProperty->SetPropertyValue(ValuePtr, FName(*FV8Utils::ToFString(Isolate, Value)));
+        NameProperty->SetPropertyValue(ValuePtr, FV8Utils::IsolateData<IObjectMapper>(Isolate)->StringToName(Isolate, Value));
         return true;
     }
 }; 
@@ -321,12 +632,20 @@ public:
 
     v8::Local<v8::Value> UEToJs(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const void *ValuePtr, bool PassByPointer) const override
     {
+#if defined(TWO_BYTE_STRING_TRANSFER)
+        return ExternalTwoByteToV8String(Isolate, TextProperty->GetPropertyValue(ValuePtr).ToString());
+#else
         return FV8Utils::ToV8String(Isolate, TextProperty->GetPropertyValue(ValuePtr));
+#endif
     }
 
     bool JsToUE(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::Local<v8::Value>& Value, void *ValuePtr, bool DeepCopy) const override
     {
+#if defined(TWO_BYTE_STRING_TRANSFER)
+        TextProperty->SetPropertyValue(ValuePtr, FText::FromString(TwoByteToFString(Isolate, Context, Value)));
+#else
         TextProperty->SetPropertyValue(ValuePtr, FText::FromString(FV8Utils::ToFString(Isolate, Value)));
+#endif
         return true;
     }
 };
@@ -402,6 +721,27 @@ public:
     {
         ScriptStruct = StructProperty->Struct;
         IsArrayBuffer = (ScriptStruct == FArrayBuffer::StaticStruct());
+
+        if (ScriptStruct == TBaseStructure<FVector>::Get())
+        {
+            MathStruct = EMathStruct::Vector;
+        }
+        else if (ScriptStruct == TBaseStructure<FRotator>::Get())
+        {
+            MathStruct = EMathStruct::Rotator;
+        }
+        else if (ScriptStruct == TBaseStructure<FQuat>::Get())
+        {
+            MathStruct = EMathStruct::Quat;
+        }
+        else if (ScriptStruct == TBaseStructure<FTransform>::Get())
+        {
+            MathStruct = EMathStruct::Transform;
+        }
+        else
+        {
+            MathStruct = EMathStruct::None;
+        }
     }
 
     v8::Local<v8::Value> UEToJs(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const void *ValuePtr, bool PassByPointer) const override //还是得有个指针模式，否则不能通过obj.xx.xx直接修改struct值，倒是和性能无关，应该强制js测不许保存指针型对象的引用（从native侧进入，最后一层退出时清空？）
@@ -415,8 +755,26 @@ public:
             return Ab;
         }
 
+        if (!PassByPointer && MathStruct != EMathStruct::None)
+        {
+            int32 TypedArrayMode = FV8Utils::IsolateData<IObjectMapper>(Isolate)->GetMathStructTypedArrayMode();
+            if (TypedArrayMode == 32)
+            {
+                return MathStructToTypedArray<float, v8::Float32Array>(Isolate, ValuePtr);
+            }
+            else if (TypedArrayMode == 64)
+            {
+                return MathStructToTypedArray<double, v8::Float64Array>(Isolate, ValuePtr);
+            }
+        }
+
         if (!PassByPointer)
         {
+            auto FrameStruct = FV8Utils::IsolateData<IObjectMapper>(Isolate)->TryAddFrameStruct(Isolate, Context, ScriptStruct, ValuePtr);
+            if (!FrameStruct.IsEmpty())
+            {
+                return FrameStruct;
+            }
             Ptr = FScriptStructWrapper::Alloc(ScriptStruct);
             StructProperty->InitializeValue(Ptr);
             StructProperty->CopySingleValue(Ptr, ValuePtr);
@@ -426,6 +784,18 @@ public:
 
     bool JsToUE(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const v8::Local<v8::Value>& Value, void *ValuePtr, bool DeepCopy) const override
     {
+        if (MathStruct != EMathStruct::None && Value->IsTypedArray())
+        {
+            if (Value->IsFloat32Array())
+            {
+                return TypedArrayToMathStruct<float>(Isolate, Value.As<v8::TypedArray>(), ValuePtr);
+            }
+            else if (Value->IsFloat64Array())
+            {
+                return TypedArrayToMathStruct<double>(Isolate, Value.As<v8::TypedArray>(), ValuePtr);
+            }
+        }
+
         FArrayBuffer ArrayBuffer;
         void * Ptr = nullptr;
         if (IsArrayBuffer && Value->IsArrayBufferView())
@@ -446,6 +816,12 @@ public:
         else
         {
             Ptr = FV8Utils::GetPoninter(Context, Value);
+            // 类型信息还在而指针被置空的是frameScope结束后的帧struct，不能当普通对象Merge成默认值
+            if (!Ptr && FV8Utils::GetPoninter(Context, Value, 1))
+            {
+                FV8Utils::ThrowException(Isolate, "access a released struct");
+                return false;
+            }
         }
 
         if (Ptr)
@@ -460,9 +836,116 @@ public:
     }
 
 private:
+    enum class EMathStruct : uint8
+    {
+        None,
+        Vector,     // X, Y, Z
+        Rotator,    // Pitch, Yaw, Roll
+        Quat,       // X, Y, Z, W
+        Transform,  // Translation.XYZ, Rotation.XYZW, Scale3D.XYZ
+    };
+
+    static const int32 MAX_MATH_STRUCT_ELEMENTS = 10;
+
+    int32 GetMathStructElements() const
+    {
+        switch (MathStruct)
+        {
+        case EMathStruct::Vector:
+        case EMathStruct::Rotator:
+            return 3;
+        case EMathStruct::Quat:
+            return 4;
+        case EMathStruct::Transform:
+            return 10;
+        default:
+            return 0;
+        }
+    }
+
+    template<typename T, typename TTypedArray>
+    v8::Local<v8::Value> MathStructToTypedArray(v8::Isolate* Isolate, const void *ValuePtr) const
+    {
+        const int32 Num = GetMathStructElements();
+        v8::Local<v8::ArrayBuffer> Ab = v8::ArrayBuffer::New(Isolate, Num * sizeof(T));
+        T *Data = static_cast<T*>(Ab->GetContents().Data());
+
+        switch (MathStruct)
+        {
+        case EMathStruct::Vector:
+        {
+            const FVector *Vector = static_cast<const FVector*>(ValuePtr);
+            Data[0] = Vector->X; Data[1] = Vector->Y; Data[2] = Vector->Z;
+            break;
+        }
+        case EMathStruct::Rotator:
+        {
+            const FRotator *Rotator = static_cast<const FRotator*>(ValuePtr);
+            Data[0] = Rotator->Pitch; Data[1] = Rotator->Yaw; Data[2] = Rotator->Roll;
+            break;
+        }
+        case EMathStruct::Quat:
+        {
+            const FQuat *Quat = static_cast<const FQuat*>(ValuePtr);
+            Data[0] = Quat->X; Data[1] = Quat->Y; Data[2] = Quat->Z; Data[3] = Quat->W;
+            break;
+        }
+        case EMathStruct::Transform:
+        {
+            const FTransform *Transform = static_cast<const FTransform*>(ValuePtr);
+            const FVector Translation = Transform->GetTranslation();
+            const FQuat Rotation = Transform->GetRotation();
+            const FVector Scale3D = Transform->GetScale3D();
+            Data[0] = Translation.X; Data[1] = Translation.Y; Data[2] = Translation.Z;
+            Data[3] = Rotation.X; Data[4] = Rotation.Y; Data[5] = Rotation.Z; Data[6] = Rotation.W;
+            Data[7] = Scale3D.X; Data[8] = Scale3D.Y; Data[9] = Scale3D.Z;
+            break;
+        }
+        default:
+            break;
+        }
+
+        return TTypedArray::New(Ab, 0, Num);
+    }
+
+    template<typename T>
+    bool TypedArrayToMathStruct(v8::Isolate* Isolate, v8::Local<v8::TypedArray> TypedArray, void *ValuePtr) const
+    {
+        const int32 Num = GetMathStructElements();
+        if (TypedArray->Length() < static_cast<size_t>(Num))
+        {
+            FV8Utils::ThrowException(Isolate, FString::Printf(TEXT("%s expect a typed array with at least %d elements"), *ScriptStruct->GetName(), Num));
+            return false;
+        }
+
+        T Data[MAX_MATH_STRUCT_ELEMENTS];
+        TypedArray->CopyContents(Data, Num * sizeof(T));
+
+        switch (MathStruct)
+        {
+        case EMathStruct::Vector:
+            *static_cast<FVector*>(ValuePtr) = FVector(Data[0], Data[1], Data[2]);
+            break;
+        case EMathStruct::Rotator:
+            *static_cast<FRotator*>(ValuePtr) = FRotator(Data[0], Data[1], Data[2]);
+            break;
+        case EMathStruct::Quat:
+            *static_cast<FQuat*>(ValuePtr) = FQuat(Data[0], Data[1], Data[2], Data[3]);
+            break;
+        case EMathStruct::Transform:
+            *static_cast<FTransform*>(ValuePtr) = FTransform(FQuat(Data[3], Data[4], Data[5], Data[6]), FVector(Data[0], Data[1], Data[2]), FVector(Data[7], Data[8], Data[9]));
+            break;
+        default:
+            break;
+        }
+        return true;
+    }
+
     UScriptStruct *ScriptStruct;
 
     bool IsArrayBuffer;
+
+    EMathStruct MathStruct;
 };
 
 class FClassPropertyTranslator : public FObjectPropertyTranslator
@@ -501,6 +984,13 @@ private:
     UClass *MetaClass;
 };
 
+// 帧struct的容器、delegate成员没有释放后的检查，不能按指针交给js，也不悄悄改成拷贝
+static v8::Local<v8::Value> ThrowFrameStructMemberAccess(v8::Isolate* Isolate)
+{
+    FV8Utils::ThrowException(Isolate, "can not access a container or delegate member of a frameScope struct, copy the struct first");
+    return v8::Undefined(Isolate);
+}
+
 //containers
 
 class FScriptArrayPropertyTranslator : public FPropertyWithDestructorReflection
@@ -512,6 +1002,10 @@ public:
 
     v8::Local<v8::Value> UEToJs(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const void *ValuePtr, bool ByPointer) const override
     {
+        if (ByPointer && FV8Utils::IsolateData<IObjectMapper>(Isolate)->IsFrameStructMemory(ValuePtr))
+        {
+            return ThrowFrameStructMemberAccess(Isolate);
+        }
         FScriptArray *ScriptArray;
         if (ByPointer)
         {
@@ -548,6 +1042,10 @@ public:
 
     v8::Local<v8::Value> UEToJs(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const void *ValuePtr, bool ByPointer) const override
     {
+        if (ByPointer && FV8Utils::IsolateData<IObjectMapper>(Isolate)->IsFrameStructMemory(ValuePtr))
+        {
+            return ThrowFrameStructMemberAccess(Isolate);
+        }
         FScriptSet *ScriptSet;
         if (ByPointer)
         {
@@ -584,6 +1082,10 @@ public:
 
     v8::Local<v8::Value> UEToJs(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, const void *ValuePtr, bool ByPointer) const override
     {
+        if (ByPointer && FV8Utils::IsolateData<IObjectMapper>(Isolate)->IsFrameStructMemory(ValuePtr))
+        {
+            return ThrowFrameStructMemberAccess(Isolate);
+        }
         FScriptMap *ScriptMap;
         if (ByPointer)
         {
@@ -670,7 +1172,12 @@ public:
             UObject* UEObject = DelegatePtr->GetUObject();
             if (UEObject && UEObject->IsValidLowLevelFast() && !UEObject->IsPendingKill())
             {
-                return FV8Utils::IsolateData<IObjectMapper>(Isolate)->FindOrAddDelegate(Isolate, Context, UEObject, DelegateProperty, DelegatePtr, PassByPointer);
+                auto ObjectMapper = FV8Utils::IsolateData<IObjectMapper>(Isolate);
+                if (PassByPointer && ObjectMapper->IsFrameStructMemory(DelegatePtr))
+                {
+                    return ThrowFrameStructMemberAccess(Isolate);
+                }
+                return ObjectMapper->FindOrAddDelegate(Isolate, Context, UEObject, DelegateProperty, DelegatePtr, PassByPointer);
             }
         }
         return v8::Undefined(Isolate);
@@ -94,5 +94,11 @@ public:
     static void DelegateGetter(v8::Local<v8::Name> Property, const v8::PropertyCallbackInfo<v8::Value>& Info);
 
     void SetAccessor(v8::Isolate* Isolate, v8::Local<v8::FunctionTemplate> Template);
+
+    // 装到已经实例化的原型对象上，用于按需创建accessor
+    bool SetAccessor(v8::Isolate* Isolate, v8::Local<v8::Context> Context, v8::Local<v8::Object> Prototype);
+
+private:
+    bool GetAccessorInfo(FString& Name, v8::AccessorNameGetterCallback& GetterCallback, v8::AccessorNameSetterCallback& SetterCallback, v8::PropertyAttribute& Attribute);
 };
 }
@@ -0,0 +1,166 @@
+/*
+* Tencent is pleased to support the open source community by making Puerts available.
+* Copyright (C) 2020 THL A29 Limited, a Tencent company.  All rights reserved.
+* Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may be subject to their corresponding license terms.
+* This file is subject to the terms and conditions defined in file 'LICENSE', which is part of this source code package.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSingleton.h"
+
+namespace puerts
+{
+// 按值传到js的UScriptStruct内存池，按16字节对齐的大小分档，每档从slab里切块，释放后挂到该档的free list上复用
+// struct的分配和释放都在isolate所在的线程，所以按线程隔离，不需要加锁
+// Free可能收到不是Malloc分配的指针（Gen wrapper里new出来按值交给js的struct），按slab地址区间判断，不是池里的还给FMemory
+class FStructMemoryPool : public TThreadSingleton<FStructMemoryPool>
+{
+public:
+    static const int32 GRANULARITY = 16;
+
+    static const int32 MAX_POOLED_SIZE = 512;
+
+    static const int32 BLOCKS_PER_SLAB = 64;
+
+    static const int32 NUM_SIZE_CLASSES = MAX_POOLED_SIZE / GRANULARITY;
+
+    struct FStatistics
+    {
+        uint64 AllocCount;
+        uint64 FreeCount;
+        uint64 ReuseCount;      // 直接从free list拿到的次数
+        uint64 UnpooledCount;   // 太大或者对齐要求太高，直接走FMemory的次数
+        uint64 SlabBytes;
+    };
+
+    FStructMemoryPool()
+    {
+        FMemory::Memzero(FreeLists, sizeof(FreeLists));
+        FMemory::Memzero(&Statistics, sizeof(Statistics));
+    }
+
+    ~FStructMemoryPool()
+    {
+        for (const FSlab& Slab : Slabs)
+        {
+            FMemory::Free(Slab.Begin);
+        }
+    }
+
+    FORCEINLINE static bool IsPooled(int32 Size, int32 Alignment)
+    {
+        return Size > 0 && Size <= MAX_POOLED_SIZE && Alignment <= GRANULARITY;
+    }
+
+    void* Malloc(int32 Size, int32 Alignment)
+    {
+        ++Statistics.AllocCount;
+        if (!IsPooled(Size, Alignment))
+        {
+            ++Statistics.UnpooledCount;
+            return FMemory::Malloc(Size, Alignment);
+        }
+
+        const int32 SizeClass = GetSizeClass(Size);
+        FFreeBlock* Block = FreeLists[SizeClass];
+        if (Block)
+        {
+            ++Statistics.ReuseCount;
+        }
+        else
+        {
+            Block = AllocSlab(SizeClass);
+        }
+        FreeLists[SizeClass] = Block->Next;
+        return Block;
+    }
+
+    void Free(void* Ptr, int32 Size, int32 Alignment)
+    {
+        ++Statistics.FreeCount;
+        if (!IsPooled(Size, Alignment) || !IsFromSlab(Ptr))
+        {
+            FMemory::Free(Ptr);
+            return;
+        }
+
+        const int32 SizeClass = GetSizeClass(Size);
+        FFreeBlock* Block = static_cast<FFreeBlock*>(Ptr);
+        Block->Next = FreeLists[SizeClass];
+        FreeLists[SizeClass] = Block;
+    }
+
+    const FStatistics& GetStatistics() const
+    {
+        return Statistics;
+    }
+
+private:
+    struct FFreeBlock
+    {
+        FFreeBlock* Next;
+    };
+
+    struct FSlab
+    {
+        uint8* Begin;
+        uint8* End;
+    };
+
+    FORCEINLINE static int32 GetSizeClass(int32 Size)
+    {
+        return (Size - 1) / GRANULARITY;
+    }
+
+    // 第一个Begin大于Ptr的slab下标
+    int32 UpperBoundSlab(const uint8* Ptr) const
+    {
+        int32 Low = 0;
+        int32 High = Slabs.Num();
+        while (Low < High)
+        {
+            const int32 Mid = (Low + High) / 2;
+            if (Slabs[Mid].Begin <= Ptr)
+            {
+                Low = Mid + 1;
+            }
+            else
+            {
+                High = Mid;
+            }
+        }
+        return Low;
+    }
+
+    bool IsFromSlab(const void* Ptr) const
+    {
+        const uint8* BytePtr = static_cast<const uint8*>(Ptr);
+        const int32 Index = UpperBoundSlab(BytePtr) - 1;
+        return Index >= 0 && BytePtr < Slabs[Index].End;
+    }
+
+    FFreeBlock* AllocSlab(int32 SizeClass)
+    {
+        const int32 BlockSize = (SizeClass + 1) * GRANULARITY;
+        uint8* Slab = static_cast<uint8*>(FMemory::Malloc(BlockSize * BLOCKS_PER_SLAB, GRANULARITY));
+        // 按地址有序，Free时二分查找
+        Slabs.Insert(FSlab{ Slab, Slab + BlockSize * BLOCKS_PER_SLAB }, UpperBoundSlab(Slab));
+        Statistics.SlabBytes += BlockSize * BLOCKS_PER_SLAB;
+
+        for (int32 i = 0; i < BLOCKS_PER_SLAB; ++i)
+        {
+            FFreeBlock* Block = reinterpret_cast<FFreeBlock*>(Slab + i * BlockSize);
+            Block->Next = (i + 1 < BLOCKS_PER_SLAB) ? reinterpret_cast<FFreeBlock*>(Slab + (i + 1) * BlockSize) : FreeLists[SizeClass];
+        }
+        return reinterpret_cast<FFreeBlock*>(Slab);
+    }
+
+    FFreeBlock* FreeLists[NUM_SIZE_CLASSES];
+
+    TArray<FSlab> Slabs;
+
+    FStatistics Statistics;
+};
+}
@@ -8,6 +8,8 @@
 #include "StructWrapper.h"
 #include "V8Utils.h"
 #include "ObjectMapper.h"
+#include "StructMemoryPool.h"
+#include "Engine/UserDefinedStruct.h"
 
 namespace puerts
 {
@@ -33,6 +35,13 @@ namespace puerts
                 ++PropertyInfo;
             }
         }
+#if defined(LAZY_ACCESSOR)
+        // UserDefinedStruct在js里用的是AuthoredName，没法按名字反查，还是一次性装好
+        if (!InStruct->IsA<UUserDefinedStruct>())
+        {
+            return;
+        }
+#endif
         for (TFieldIterator<PropertyMacro> PropertyIt(InStruct, EFieldIteratorFlags::ExcludeSuper); PropertyIt; ++PropertyIt)
         {
             PropertyMacro *Property = *PropertyIt;
@@ -99,6 +108,14 @@ namespace puerts
                     continue;
                 }
 
+#if defined(LAZY_ACCESSOR)
+                if (!Function->HasAnyFunctionFlags(FUNC_Static))
+                {
+                    AddedMethods.Add(Function->GetName());
+                    continue;
+                }
+#endif
+
                 auto FunctionTranslator = std::make_unique<FFunctionTranslator>(Function);
 
                 auto Key = FV8Utils::InternalString(Isolate, Function->GetName());
@@ -141,6 +158,13 @@ namespace puerts
 
         Result->Set(FV8Utils::InternalString(Isolate, "StaticClass"), v8::FunctionTemplate::New(Isolate, StaticClass, v8::External::New(Isolate, this)));
 
+#if defined(LAZY_ACCESSOR)
+        // kNonMasking: 整条原型链上都找不到才会进来，装好之后就不再经过拦截器
+        Result->InstanceTemplate()->SetHandler(v8::NamedPropertyHandlerConfiguration(LazyGetter, LazySetter, nullptr, nullptr, nullptr,
+            v8::External::New(Isolate, this),
+            static_cast<v8::PropertyHandlerFlags>(static_cast<int>(v8::PropertyHandlerFlags::kNonMasking) | static_cast<int>(v8::PropertyHandlerFlags::kOnlyInterceptStrings))));
+#endif
+
         
 
         return HandleScope.Escape(Result);
@@ -229,9 +253,373 @@ namespace puerts
         }
     }
 
+#if defined(LAZY_ACCESSOR)
+    void FStructWrapper::LazyGetter(v8::Local<v8::Name> Name, const v8::PropertyCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::Isolate::Scope IsolateScope(Isolate);
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+        v8::Context::Scope ContextScope(Context);
+
+        FStructWrapper * This = reinterpret_cast<FStructWrapper *>((v8::Local<v8::External>::Cast(Info.Data()))->Value());
+
+        if (This->LazyInstall(Isolate, Context, Name, Info.This()))
+        {
+            v8::Local<v8::Value> Result;
+            if (Info.This()->Get(Context, Name).ToLocal(&Result))
+            {
+                Info.GetReturnValue().Set(Result);
+            }
+        }
+    }
+
+    void FStructWrapper::LazySetter(v8::Local<v8::Name> Name, v8::Local<v8::Value> Value, const v8::PropertyCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::Isolate::Scope IsolateScope(Isolate);
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+        v8::Context::Scope ContextScope(Context);
+
+        FStructWrapper * This = reinterpret_cast<FStructWrapper *>((v8::Local<v8::External>::Cast(Info.Data()))->Value());
+
+        if (This->LazyInstall(Isolate, Context, Name, Info.This()))
+        {
+            // 设置了返回值表示已拦截，否则v8会在对象上新建一个同名属性
+            Info.This()->Set(Context, Name, Value).FromMaybe(false);
+            Info.GetReturnValue().Set(Value);
+        }
+    }
+
+    // 在Receiver的直接原型上装accessor或者成员函数，父类的属性也装在子类原型上，返回false表示不是UE的属性或函数
+    bool FStructWrapper::LazyInstall(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, v8::Local<v8::Name> Name, v8::Local<v8::Object> Receiver)
+    {
+        FString NameString = FV8Utils::ToFString(Isolate, Name);
+        FName Key(*NameString, FNAME_Find);
+        if (Key.IsNone())
+        {
+            return false;
+        }
+        v8::Local<v8::Value> Prototype = Receiver->GetPrototype();
+        if (!Prototype->IsObject())
+        {
+            return false;
+        }
+
+        // FName比较不区分大小写，名字不完全一致的话装上去也还是找不到，会再次进入拦截器
+        PropertyMacro* Property = Struct->FindPropertyByName(Key);
+        if (Property && Property->GetName().Equals(NameString, ESearchCase::CaseSensitive))
+        {
+            auto PropertyTranslator = FPropertyTranslator::Create(Property);
+            if (PropertyTranslator && PropertyTranslator->SetAccessor(Isolate, Context, Prototype.As<v8::Object>()))
+            {
+                Properties.push_back(std::move(PropertyTranslator));
+                return true;
+            }
+            return false;
+        }
+
+        if (Struct->IsA<UClass>())
+        {
+            UFunction* Function = Class->FindFunctionByName(Key);
+            if (Function && !Function->HasAnyFunctionFlags(FUNC_Static) && Function->GetName().Equals(NameString, ESearchCase::CaseSensitive))
+            {
+                auto FunctionTranslator = std::make_unique<FFunctionTranslator>(Function);
+                if (Prototype.As<v8::Object>()->Set(Context, Name, FunctionTranslator->ToFunctionTemplate(Isolate)->GetFunction(Context).ToLocalChecked()).FromMaybe(false))
+                {
+                    Functions.push_back(std::move(FunctionTranslator));
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+#endif
+
     v8::Local<v8::FunctionTemplate> FScriptStructWrapper::ToFunctionTemplate(v8::Isolate* Isolate)
     {
-        return FStructWrapper::ToFunctionTemplate(Isolate, New);
+        auto Result = FStructWrapper::ToFunctionTemplate(Isolate, New);
+        Result->Set(FV8Utils::InternalString(Isolate, "toPlain"), v8::FunctionTemplate::New(Isolate, ToPlain, v8::External::New(Isolate, this)));
+        Result->Set(FV8Utils::InternalString(Isolate, "fromPlain"), v8::FunctionTemplate::New(Isolate, FromPlain, v8::External::New(Isolate, this)));
+        Result->Set(FV8Utils::InternalString(Isolate, "toBuffer"), v8::FunctionTemplate::New(Isolate, ToBuffer, v8::External::New(Isolate, this)));
+        Result->Set(FV8Utils::InternalString(Isolate, "fromBuffer"), v8::FunctionTemplate::New(Isolate, FromBuffer, v8::External::New(Isolate, this)));
+        Result->Set(FV8Utils::InternalString(Isolate, "bufferLayout"), v8::FunctionTemplate::New(Isolate, BufferLayout, v8::External::New(Isolate, this)));
+        return Result;
+    }
+
+    void FScriptStructWrapper::InitPlainFields(v8::Isolate* Isolate)
+    {
+        if (PlainFieldsInitialized)
+        {
+            return;
+        }
+        PlainFieldsInitialized = true;
+
+        const bool IsUserDefinedStruct = ScriptStruct->IsA<UUserDefinedStruct>();
+        for (TFieldIterator<PropertyMacro> PropertyIt(ScriptStruct); PropertyIt; ++PropertyIt)
+        {
+            PropertyMacro *Property = *PropertyIt;
+            auto PropertyTranslator = FPropertyTranslator::Create(Property);
+            if (!PropertyTranslator)
+            {
+                continue;
+            }
+            FString Name = IsUserDefinedStruct ?
+#if ENGINE_MINOR_VERSION >= 23 || ENGINE_MAJOR_VERSION > 4
+                Property->GetAuthoredName()
+#else
+                Property->GetDisplayNameText().ToString()
+#endif
+                : Property->GetName();
+
+            FPlainField PlainField;
+            PlainField.Name.Set(Isolate, v8::String::NewFromUtf8(Isolate, TCHAR_TO_UTF8(*Name), v8::NewStringType::kInternalized).ToLocalChecked());
+            PlainField.Translator = std::move(PropertyTranslator);
+            PlainField.IsPrimitive = Property->IsA<NumericPropertyMacro>() || Property->IsA<EnumPropertyMacro>() || Property->IsA<BoolPropertyMacro>();
+            PlainFields.push_back(std::move(PlainField));
+        }
+    }
+
+    void* FScriptStructWrapper::GetStructPointer(v8::Isolate* Isolate, v8::Local<v8::Value> Value)
+    {
+        if (!Value->IsObject() || !FV8Utils::IsolateData<IObjectMapper>(Isolate)->IsInstanceOf(ScriptStruct, Value.As<v8::Object>()))
+        {
+            return nullptr;
+        }
+        return FV8Utils::GetPoninter(Value.As<v8::Object>());
+    }
+
+    FScriptStructWrapper* FScriptStructWrapper::GetPlainFieldsWrapper(const v8::FunctionCallbackInfo<v8::Value>& Info, int32 MinArgs)
+    {
+        if (!FV8Utils::CheckArgumentLength(Info, MinArgs))
+        {
+            return nullptr;
+        }
+        FScriptStructWrapper * This = reinterpret_cast<FScriptStructWrapper *>((v8::Local<v8::External>::Cast(Info.Data()))->Value());
+        This->InitPlainFields(Info.GetIsolate());
+        return This;
+    }
+
+    static uint8* GetBufferData(v8::Local<v8::Value> Value, size_t& Length)
+    {
+        if (Value->IsArrayBufferView())
+        {
+            v8::Local<v8::ArrayBufferView> BuffView = Value.As<v8::ArrayBufferView>();
+            Length = BuffView->ByteLength();
+            return static_cast<uint8*>(BuffView->Buffer()->GetContents().Data()) + BuffView->ByteOffset();
+        }
+        if (Value->IsArrayBuffer())
+        {
+            auto Contents = Value.As<v8::ArrayBuffer>()->GetContents();
+            Length = Contents.ByteLength();
+            return static_cast<uint8*>(Contents.Data());
+        }
+        return nullptr;
+    }
+
+    void FScriptStructWrapper::ToPlain(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::Isolate::Scope IsolateScope(Isolate);
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+        v8::Context::Scope ContextScope(Context);
+
+        FScriptStructWrapper * This = GetPlainFieldsWrapper(Info, 1);
+        if (!This) return;
+
+        void* Ptr = This->GetStructPointer(Isolate, Info[0]);
+        if (!Ptr)
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #0, expect a instance of this struct.");
+            return;
+        }
+
+        auto Result = v8::Object::New(Isolate);
+        for (auto& PlainField : This->PlainFields)
+        {
+            Result->CreateDataProperty(Context, PlainField.Name.Get(Isolate), PlainField.Translator->UEToJsInContainer(Isolate, Context, Ptr)).Check();
+        }
+        Info.GetReturnValue().Set(Result);
+    }
+
+    void FScriptStructWrapper::FromPlain(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::Isolate::Scope IsolateScope(Isolate);
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+        v8::Context::Scope ContextScope(Context);
+
+        FScriptStructWrapper * This = GetPlainFieldsWrapper(Info, 2);
+        if (!This) return;
+
+        void* Ptr = This->GetStructPointer(Isolate, Info[0]);
+        if (!Ptr)
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #0, expect a instance of this struct.");
+            return;
+        }
+        if (!Info[1]->IsObject())
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #1, expect a object.");
+            return;
+        }
+
+        auto Plain = Info[1].As<v8::Object>();
+        for (auto& PlainField : This->PlainFields)
+        {
+            v8::Local<v8::Value> Value;
+            if (!Plain->Get(Context, PlainField.Name.Get(Isolate)).ToLocal(&Value))
+            {
+                return;
+            }
+            if (!Value->IsUndefined())
+            {
+                PlainField.Translator->JsToUEInContainer(Isolate, Context, Value, Ptr, true);
+            }
+        }
+    }
+
+    // 按原生内存布局导出，只拷贝数值、枚举和bool字段，其它字段所在的区域填0（传入的buffer也一样）；POD结构体直接整块拷贝
+    void FScriptStructWrapper::ToBuffer(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::Isolate::Scope IsolateScope(Isolate);
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+        v8::Context::Scope ContextScope(Context);
+
+        FScriptStructWrapper * This = GetPlainFieldsWrapper(Info, 1);
+        if (!This) return;
+
+        uint8* Ptr = static_cast<uint8*>(This->GetStructPointer(Isolate, Info[0]));
+        if (!Ptr)
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #0, expect a instance of this struct.");
+            return;
+        }
+
+        const size_t StructSize = This->ScriptStruct->GetStructureSize();
+        v8::Local<v8::Value> Result;
+        uint8* Buffer = nullptr;
+        if (Info.Length() > 1 && !Info[1]->IsUndefined())
+        {
+            size_t Length = 0;
+            Buffer = GetBufferData(Info[1], Length);
+            if (!Buffer || Length < StructSize)
+            {
+                FV8Utils::ThrowException(Isolate, "Bad parameters #1, expect a ArrayBuffer or ArrayBufferView large enough.");
+                return;
+            }
+            Result = Info[1];
+            if (!(This->ScriptStruct->StructFlags & STRUCT_IsPlainOldData))
+            {
+                // 传入的buffer可能有旧数据，先清零再写
+                FMemory::Memzero(Buffer, StructSize);
+            }
+        }
+        else
+        {
+            auto Ab = v8::ArrayBuffer::New(Isolate, StructSize);
+            Buffer = static_cast<uint8*>(Ab->GetContents().Data());
+            Result = Ab;
+        }
+
+        if (This->ScriptStruct->StructFlags & STRUCT_IsPlainOldData)
+        {
+            FMemory::Memcpy(Buffer, Ptr, StructSize);
+        }
+        else
+        {
+            for (auto& PlainField : This->PlainFields)
+            {
+                if (PlainField.IsPrimitive)
+                {
+                    PropertyMacro* Property = PlainField.Translator->Property;
+                    const int32 Offset = Property->GetOffset_ForInternal();
+                    FMemory::Memcpy(Buffer + Offset, Ptr + Offset, Property->ElementSize * Property->ArrayDim);
+                }
+            }
+        }
+        Info.GetReturnValue().Set(Result);
+    }
+
+    void FScriptStructWrapper::FromBuffer(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::Isolate::Scope IsolateScope(Isolate);
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+        v8::Context::Scope ContextScope(Context);
+
+        FScriptStructWrapper * This = GetPlainFieldsWrapper(Info, 2);
+        if (!This) return;
+
+        uint8* Ptr = static_cast<uint8*>(This->GetStructPointer(Isolate, Info[0]));
+        if (!Ptr)
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #0, expect a instance of this struct.");
+            return;
+        }
+
+        const size_t StructSize = This->ScriptStruct->GetStructureSize();
+        size_t Length = 0;
+        const uint8* Buffer = GetBufferData(Info[1], Length);
+        if (!Buffer || Length < StructSize)
+        {
+            FV8Utils::ThrowException(Isolate, "Bad parameters #1, expect a ArrayBuffer or ArrayBufferView large enough.");
+            return;
+        }
+
+        if (This->ScriptStruct->StructFlags & STRUCT_IsPlainOldData)
+        {
+            FMemory::Memcpy(Ptr, Buffer, StructSize);
+            return;
+        }
+        for (auto& PlainField : This->PlainFields)
+        {
+            if (PlainField.IsPrimitive)
+            {
+                PropertyMacro* Property = PlainField.Translator->Property;
+                const int32 Offset = Property->GetOffset_ForInternal();
+                if (BoolPropertyMacro* BoolProperty = CastFieldMacro<BoolPropertyMacro>(Property))
+                {
+                    // bitfield和同一字节的其它bool共用，不能整字节覆盖
+                    for (int32 i = 0; i < Property->ArrayDim; ++i)
+                    {
+                        const int32 ElementOffset = Offset + Property->ElementSize * i;
+                        BoolProperty->SetPropertyValue(Ptr + ElementOffset, BoolProperty->GetPropertyValue(Buffer + ElementOffset));
+                    }
+                }
+                else
+                {
+                    FMemory::Memcpy(Ptr + Offset, Buffer + Offset, Property->ElementSize * Property->ArrayDim);
+                }
+            }
+        }
+    }
+
+    void FScriptStructWrapper::BufferLayout(const v8::FunctionCallbackInfo<v8::Value>& Info)
+    {
+        v8::Isolate* Isolate = Info.GetIsolate();
+        v8::Isolate::Scope IsolateScope(Isolate);
+        v8::HandleScope HandleScope(Isolate);
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+        v8::Context::Scope ContextScope(Context);
+
+        FScriptStructWrapper * This = GetPlainFieldsWrapper(Info, 0);
+
+        auto Result = v8::Object::New(Isolate);
+        for (auto& PlainField : This->PlainFields)
+        {
+            if (PlainField.IsPrimitive)
+            {
+                Result->CreateDataProperty(Context, PlainField.Name.Get(Isolate), v8::Integer::New(Isolate, PlainField.Translator->Property->GetOffset_ForInternal())).Check();
+            }
+        }
+        Info.GetReturnValue().Set(Result);
     }
 
     void FScriptStructWrapper::New(const v8::FunctionCallbackInfo<v8::Value>& Info)
@@ -284,29 +672,23 @@ namespace puerts
         }
     }
 
-    void * FScriptStructWrapper::Alloc(UScriptStruct *InScriptStruct)
+    static FORCEINLINE int32 GetScriptStructAlignment(UScriptStruct *InScriptStruct)
     {
         UScriptStruct::ICppStructOps *CppStructOps = InScriptStruct->GetCppStructOps();
-        int32 Alignment = CppStructOps ? CppStructOps->GetAlignment() : InScriptStruct->GetMinAlignment();
-        void *ScriptStructMemory = FMemory::Malloc(InScriptStruct->GetStructureSize(), Alignment);
-        InScriptStruct->InitializeStruct(ScriptStructMemory);
-        return ScriptStructMemory;
+        return CppStructOps ? CppStructOps->GetAlignment() : InScriptStruct->GetMinAlignment();
     }
 
-    void FScriptStructWrapper::OnGarbageCollectedWithFree(const v8::WeakCallbackInfo<UScriptStruct>& Data)
+    void * FScriptStructWrapper::Alloc(UScriptStruct *InScriptStruct)
     {
-        UScriptStruct *ScriptStruct = Data.GetParameter();
-        void *ScriptStructMemory = DataTransfer::MakeAddressWithHighPartOfTwo(Data.GetInternalField(0), Data.GetInternalField(1));
-        FV8Utils::IsolateData<IObjectMapper>(Data.GetIsolate())->UnBindStruct(ScriptStruct, ScriptStructMemory);
-        ScriptStruct->DestroyStruct(ScriptStructMemory);
-        FMemory::Free(ScriptStructMemory);
+        void *ScriptStructMemory = FStructMemoryPool::Get().Malloc(InScriptStruct->GetStructureSize(), GetScriptStructAlignment(InScriptStruct));
+        InScriptStruct->InitializeStruct(ScriptStructMemory);
+        return ScriptStructMemory;
     }
 
-    void  FScriptStructWrapper::OnGarbageCollected(const v8::WeakCallbackInfo<UScriptStruct>& Data)
+    void FScriptStructWrapper::Free(UScriptStruct *InScriptStruct, void *Ptr)
     {
-        UScriptStruct *ScriptStruct = Data.GetParameter();
-        void *ScriptStructMemory = DataTransfer::MakeAddressWithHighPartOfTwo(Data.GetInternalField(0), Data.GetInternalField(1));
-        FV8Utils::IsolateData<IObjectMapper>(Data.GetIsolate())->UnBindStruct(ScriptStruct, ScriptStructMemory);
+        InScriptStruct->DestroyStruct(Ptr);
+        FStructMemoryPool::Get().Free(Ptr, InScriptStruct->GetStructureSize(), GetScriptStructAlignment(InScriptStruct));
     }
 
     v8::Local<v8::FunctionTemplate> FClassWrapper::ToFunctionTemplate(v8::Isolate* Isolate)
@@ -314,11 +696,6 @@ namespace puerts
         return FStructWrapper::ToFunctionTemplate(Isolate, New);
     }
 
-    void FClassWrapper::OnGarbageCollected(const v8::WeakCallbackInfo<UClass>& Data)
-    {
-        FV8Utils::IsolateData<IObjectMapper>(Data.GetIsolate())->UnBind(Data.GetParameter(), reinterpret_cast<UObject*>(DataTransfer::MakeAddressWithHighPartOfTwo(Data.GetInternalField(0), Data.GetInternalField(1))));
-    }
-
 
     void FClassWrapper::New(const v8::FunctionCallbackInfo<v8::Value>& Info)
     {
@@ -55,6 +55,14 @@ protected:
     static void Find(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
     static void Load(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+#if defined(LAZY_ACCESSOR)
+    static void LazyGetter(v8::Local<v8::Name> Name, const v8::PropertyCallbackInfo<v8::Value>& Info);
+
+    static void LazySetter(v8::Local<v8::Name> Name, v8::Local<v8::Value> Value, const v8::PropertyCallbackInfo<v8::Value>& Info);
+
+    bool LazyInstall(v8::Isolate* Isolate, v8::Local<v8::Context>& Context, v8::Local<v8::Name> Name, v8::Local<v8::Object> Receiver);
+#endif
 };
 
 class FScriptStructWrapper : public FStructWrapper
@@ -64,13 +72,38 @@ public:
 
     v8::Local<v8::FunctionTemplate> ToFunctionTemplate(v8::Isolate* Isolate);
 
-    static void OnGarbageCollectedWithFree(const v8::WeakCallbackInfo<UScriptStruct>& Data);
-
-    static void OnGarbageCollected(const v8::WeakCallbackInfo<UScriptStruct>& Data);
-
     static void *Alloc(UScriptStruct *InScriptStruct);
+
+    // DestroyStruct并释放内存，不是Alloc分配的（外部new出来按值交给js的）还给FMemory
+    static void Free(UScriptStruct *InScriptStruct, void *Ptr);
 private:
-        
+    // toPlain/fromPlain/toBuffer/fromBuffer用到的字段表，第一次用时构建，包括父结构体的字段
+    struct FPlainField
+    {
+        v8::Eternal<v8::String> Name;
+        std::unique_ptr<FPropertyTranslator> Translator;
+        bool IsPrimitive; // 数值、枚举和bool，可以按原生偏移直接拷贝到buffer
+    };
+
+    std::vector<FPlainField> PlainFields;
+
+    bool PlainFieldsInitialized = false;
+
+    void InitPlainFields(v8::Isolate* Isolate);
+
+    void* GetStructPointer(v8::Isolate* Isolate, v8::Local<v8::Value> Value);
+
+    static FScriptStructWrapper* GetPlainFieldsWrapper(const v8::FunctionCallbackInfo<v8::Value>& Info, int32 MinArgs);
+
+    static void ToPlain(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    static void FromPlain(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    static void ToBuffer(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    static void FromBuffer(const v8::FunctionCallbackInfo<v8::Value>& Info);
+
+    static void BufferLayout(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
 private:
     static void New(const v8::FunctionCallbackInfo<v8::Value>& Info);
@@ -85,8 +118,6 @@ public:
 
     v8::Local<v8::FunctionTemplate> ToFunctionTemplate(v8::Isolate* Isolate);
 
-    static void OnGarbageCollected(const v8::WeakCallbackInfo<UClass>& Data);
-
 private:
     static void New(const v8::FunctionCallbackInfo<v8::Value>& Info);
 
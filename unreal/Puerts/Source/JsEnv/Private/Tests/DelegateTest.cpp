@@ -0,0 +1,91 @@
+/*
+* Tencent is pleased to support the open source community by making Puerts available.
+* Copyright (C) 2020 THL A29 Limited, a Tencent company.  All rights reserved.
+* Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may be subject to their corresponding license terms.
+* This file is subject to the terms and conditions defined in file 'LICENSE', which is part of this source code package.
+*/
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "JsEnv.h"
+#include "DelegateTestObject.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace puerts
+{
+namespace
+{
+const TCHAR* RecursiveDelegateModule = TEXT("puerts_test/recursive_delegate.js");
+
+// Depth > 0时先用不同的参数递归触发同一个delegate，内层返回后再记录本层的参数，out参数写Depth + 1000
+const TCHAR* RecursiveDelegateSource = TEXT(R"(
+const Target = puerts.argv.getByName("Target");
+Target.OnRecursive.Add((Depth, Tag, Result) => {
+    if (Depth > 0) {
+        const Inner = Target.Fire(Depth - 1, "inner" + (Depth - 1));
+        Target.Log.Add(Depth + ":" + Tag + ":" + Inner);
+    }
+    Result.value = Depth + 1000;
+});
+)");
+
+// 测试脚本从内存加载，其它模块（puerts/*.js）照常从Content/JavaScript找
+class FTestModuleLoader : public DefaultJSModuleLoader
+{
+public:
+    FTestModuleLoader() : DefaultJSModuleLoader(TEXT("JavaScript")) {}
+
+    bool Search(const FString& RequiredDir, const FString& RequiredModule, FString& Path, FString& AbsolutePath) override
+    {
+        if (RequiredModule == RecursiveDelegateModule)
+        {
+            Path = AbsolutePath = RecursiveDelegateModule;
+            return true;
+        }
+        return DefaultJSModuleLoader::Search(RequiredDir, RequiredModule, Path, AbsolutePath);
+    }
+
+    bool Load(const FString& Path, TArray<uint8>& Content) override
+    {
+        if (Path == RecursiveDelegateModule)
+        {
+            FTCHARToUTF8 Source(RecursiveDelegateSource);
+            Content.Reset(Source.Length());
+            Content.Append(reinterpret_cast<const uint8*>(Source.Get()), Source.Length());
+            return true;
+        }
+        return DefaultJSModuleLoader::Load(Path, Content);
+    }
+};
+}    // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRecursiveDelegateTest, "Puerts.Delegate.RecursiveDispatch",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FRecursiveDelegateTest::RunTest(const FString& Parameters)
+{
+    UPuertsDelegateTestObject* Target = NewObject<UPuertsDelegateTestObject>();
+    Target->AddToRoot();
+    {
+        FJsEnv JsEnv(std::make_unique<FTestModuleLoader>(), std::make_shared<FDefaultLogger>(), -1);
+        JsEnv.Start(RecursiveDelegateModule, { TPair<FString, UObject*>(TEXT("Target"), Target) });
+
+        // 外层的out参数不能被内层调用的覆盖
+        TestEqual(TEXT("outer out param"), Target->Fire(2, TEXT("outer")), 1002);
+        // 内层返回后，外层js回调看到的仍是自己的参数
+        if (TestEqual(TEXT("log count"), Target->Log.Num(), 2))
+        {
+            TestEqual(TEXT("inner call"), Target->Log[0], FString(TEXT("1:inner1:1000")));
+            TestEqual(TEXT("outer call"), Target->Log[1], FString(TEXT("2:outer:1001")));
+        }
+
+        Target->OnRecursive.Clear();
+    }
+    Target->RemoveFromRoot();
+
+    return true;
+}
+}    // namespace puerts
+
+#endif
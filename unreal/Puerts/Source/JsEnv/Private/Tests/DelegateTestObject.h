@@ -0,0 +1,36 @@
+/*
+* Tencent is pleased to support the open source community by making Puerts available.
+* Copyright (C) 2020 THL A29 Limited, a Tencent company.  All rights reserved.
+* Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may be subject to their corresponding license terms.
+* This file is subject to the terms and conditions defined in file 'LICENSE', which is part of this source code package.
+*/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "DelegateTestObject.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FPuertsRecursiveTestDelegate, int32, Depth, const FString&, Tag, int32&, Result);
+
+// 自动化测试用，js里绑定OnRecursive后在回调里再调Fire，触发同一个delegate的递归调用
+UCLASS(Transient)
+class UPuertsDelegateTestObject : public UObject
+{
+    GENERATED_BODY()
+public:
+    UPROPERTY()
+    FPuertsRecursiveTestDelegate OnRecursive;
+
+    // js回调在内层调用返回后记录自己收到的参数
+    UPROPERTY()
+    TArray<FString> Log;
+
+    UFUNCTION()
+    int32 Fire(int32 Depth, const FString& Tag)
+    {
+        int32 Result = -1;
+        OnRecursive.Broadcast(Depth, Tag, Result);
+        return Result;
+    }
+};
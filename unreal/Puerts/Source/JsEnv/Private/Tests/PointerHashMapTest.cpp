@@ -0,0 +1,172 @@
+/*
+* Tencent is pleased to support the open source community by making Puerts available.
+* Copyright (C) 2020 THL A29 Limited, a Tencent company.  All rights reserved.
+* Puerts is licensed under the BSD 3-Clause License, except for the third-party components listed in the file 'LICENSE' which may be subject to their corresponding license terms.
+* This file is subject to the terms and conditions defined in file 'LICENSE', which is part of this source code package.
+*/
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "PointerHashMap.h"
+#include <map>
+#include <memory>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace puerts
+{
+namespace
+{
+struct FFakeObject
+{
+    uint8 Pad[56];
+};
+
+// 和JsEnvImpl里的用法一致：先find，找不到再插入，期间会erase一半的key
+template<typename TMap>
+double RunFindOrAdd(const TArray<FFakeObject*>& Keys, const TArray<FFakeObject*>& Order, int32 Rounds, int64& Sum)
+{
+    double Start = FPlatformTime::Seconds();
+    for (int32 Round = 0; Round < Rounds; ++Round)
+    {
+        TMap Map;
+        for (FFakeObject* Key : Keys)
+        {
+            Map[Key] = 1;
+        }
+        for (int32 i = 0; i < 10; ++i)
+        {
+            for (FFakeObject* Key : Order)
+            {
+                auto Iter = Map.find(Key);
+                if (Iter == Map.end())
+                {
+                    Map[Key] = 1;
+                }
+                else
+                {
+                    Sum += Iter->second;
+                }
+            }
+        }
+        for (int32 i = 0; i < Keys.Num(); i += 2)
+        {
+            Map.erase(Keys[i]);
+        }
+        for (FFakeObject* Key : Order)
+        {
+            auto Iter = Map.find(Key);
+            if (Iter == Map.end())
+            {
+                Map[Key] = 2;
+            }
+            else
+            {
+                Sum += Iter->second;
+            }
+        }
+    }
+    return (FPlatformTime::Seconds() - Start) * 1000 / Rounds;
+}
+}    // namespace
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPointerHashMapTest, "Puerts.PointerHashMap.Basic",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPointerHashMapTest::RunTest(const FString& Parameters)
+{
+    std::vector<std::unique_ptr<FFakeObject>> Storage;
+    for (int32 i = 0; i < 5000; ++i)
+    {
+        Storage.emplace_back(new FFakeObject());
+    }
+
+    TPointerHashMap<FFakeObject*, int32> Map;
+    std::map<FFakeObject*, int32> Expected;
+    FRandomStream Random(7);
+    for (int32 i = 0; i < 200000; ++i)
+    {
+        FFakeObject* Key = Storage[Random.RandHelper((int32) Storage.size())].get();
+        switch (Random.RandHelper(3))
+        {
+            case 0:
+                Map[Key] = i;
+                Expected[Key] = i;
+                break;
+            case 1:
+                TestEqual(TEXT("erase"), (int32) Map.erase(Key), (int32) Expected.erase(Key));
+                break;
+            default:
+            {
+                auto Iter = Map.find(Key);
+                auto ExpectedIter = Expected.find(Key);
+                TestTrue(TEXT("find"), (Iter == Map.end()) == (ExpectedIter == Expected.end()));
+                if (Iter != Map.end() && ExpectedIter != Expected.end())
+                {
+                    TestEqual(TEXT("value"), Iter->second, ExpectedIter->second);
+                }
+            }
+        }
+    }
+    TestEqual(TEXT("size"), (int32) Map.size(), (int32) Expected.size());
+
+    // erase其它key和访问已有key都不能让引用失效
+    FFakeObject* Kept = Storage[0].get();
+    int32& Ref = Map[Kept];
+    Ref = 123;
+    for (size_t i = 1; i < Storage.size(); ++i)
+    {
+        Map.erase(Storage[i].get());
+    }
+    TestTrue(TEXT("reference stable across erase"), &Map[Kept] == &Ref && Ref == 123);
+
+    // 边遍历边erase
+    for (int32 i = 0; i < 1000; ++i)
+    {
+        Map[Storage[i].get()] = i;
+    }
+    for (auto Iter = Map.begin(); Iter != Map.end(); ++Iter)
+    {
+        Map.erase(Iter);
+    }
+    TestTrue(TEXT("erase while iterating"), Map.empty() && Map.begin() == Map.end());
+
+    return true;
+}
+
+// 100k对象的FindOrAdd，对比替换前的std::map，结果输出到日志
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPointerHashMapPerfTest, "Puerts.PointerHashMap.FindOrAddPerf",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FPointerHashMapPerfTest::RunTest(const FString& Parameters)
+{
+    const int32 ObjectCount = 100000;
+    const int32 Rounds = 5;
+
+    std::vector<std::unique_ptr<FFakeObject>> Storage;
+    TArray<FFakeObject*> Keys;
+    for (int32 i = 0; i < ObjectCount; ++i)
+    {
+        Storage.emplace_back(new FFakeObject());
+        Keys.Add(Storage.back().get());
+    }
+    TArray<FFakeObject*> Order = Keys;
+    FRandomStream Random(1);
+    for (int32 i = Order.Num() - 1; i > 0; --i)
+    {
+        Order.Swap(i, Random.RandHelper(i + 1));
+    }
+
+    int64 Sum = 0;
+    double StdMapMs = RunFindOrAdd<std::map<FFakeObject*, int32>>(Keys, Order, Rounds, Sum);
+    double HashMapMs = RunFindOrAdd<TPointerHashMap<FFakeObject*, int32>>(Keys, Order, Rounds, Sum);
+
+    AddInfo(FString::Printf(TEXT("FindOrAdd x %d objects: std::map %.2fms, TPointerHashMap %.2fms (checksum %lld)"), ObjectCount,
+        StdMapMs, HashMapMs, Sum));
+    TestTrue(TEXT("TPointerHashMap not slower than std::map"), HashMapMs <= StdMapMs);
+
+    return true;
+}
+}    // namespace puerts
+
+#endif
@@ -23,6 +23,20 @@
 
 namespace puerts
 {
+struct FJsEnvGCSettings
+{
+    // run a full V8 GC (through a critical memory pressure notification) right before UE's CollectGarbage,
+    // so UObjects only referenced by dead wrappers are freed in the same cycle
+    bool GCBeforeUEGC = false;
+
+    // upper bound (milliseconds) handed to V8 through IdleNotificationDeadline per frame, only spent when the previous frame
+    // had idle time (FApp::GetIdleTime, e.g. waiting for the frame rate limit) and never more than that, 0 to disable
+    float IdleGCTimeBudgetMs = 0;
+
+    // notify V8 of memory pressure when the used heap exceeds this size (MB), 0 to disable
+    int32 MemoryPressureThresholdMB = 0;
+};
+
 class JSENV_API IJsEnv
 {
 public:
@@ -30,6 +44,8 @@ public:
 
     virtual void LowMemoryNotification() = 0;
 
+    virtual void SetGCSettings(const FJsEnvGCSettings& Settings) = 0;
+
     virtual void WaitDebugger(double timeout) = 0;
 
     virtual void TryBindJs(const class UObjectBase *InObject) = 0;
@@ -57,6 +73,8 @@ public:
 
     void LowMemoryNotification();
 
+    void SetGCSettings(const FJsEnvGCSettings& Settings);
+
     void WaitDebugger(double timeout = 0);
 
     void TryBindJs(const class UObjectBase *InObject);
@@ -34,6 +34,8 @@ public:
 
     void InitExtensionMethodsMap();
 
+    void SetGCSettings(const FJsEnvGCSettings& Settings);
+
     std::shared_ptr<IJsEnv> Get(int Index);
 
     void SetJsEnvSelector(std::function<int(UObject*, int)> InSelector);
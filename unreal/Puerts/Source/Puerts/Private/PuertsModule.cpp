@@ -175,6 +175,11 @@ public:
 
         NumberOfJsEnv = (Settings.NumberOfJsEnv > 1 && Settings.NumberOfJsEnv < 10) ? Settings.NumberOfJsEnv : 1;
 
+        puerts::FJsEnvGCSettings GCSettings;
+        GCSettings.GCBeforeUEGC = Settings.GCBeforeUEGC;
+        GCSettings.IdleGCTimeBudgetMs = Settings.IdleGCTimeBudgetMs;
+        GCSettings.MemoryPressureThresholdMB = Settings.MemoryPressureThresholdMB;
+
         if (NumberOfJsEnv > 1)
         {
             if (Settings.DebugEnable)
@@ -197,6 +202,7 @@ public:
                 UE_LOG(PuertsModule, Warning, TEXT("Do not support WaitDebugger in Group Mode!"));
             }
 
+            JsEnvGroup->SetGCSettings(GCSettings);
             JsEnvGroup->RebindJs();
             UE_LOG(PuertsModule, Log, TEXT("Group Mode started! Number of JsEnv is %d"), NumberOfJsEnv);
         }
@@ -216,6 +222,7 @@ public:
                 JsEnv->WaitDebugger(Settings.WaitDebuggerTimeout);
             }
 
+            JsEnv->SetGCSettings(GCSettings);
             JsEnv->RebindJs();
             UE_LOG(PuertsModule, Log, TEXT("Normal Mode started!"));
         }
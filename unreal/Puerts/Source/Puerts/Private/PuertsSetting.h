@@ -36,4 +36,13 @@ public:
 	
     UPROPERTY(config, EditAnywhere, Category = "Setting", meta = (DisplayName = "Number of JavaScript Env", defaultValue = 1))
     int32 NumberOfJsEnv = 1;
+
+    UPROPERTY(config, EditAnywhere, Category = "Setting", meta = (DisplayName = "V8 GC Before UE GC", defaultValue = false))
+    bool GCBeforeUEGC = false;
+
+    UPROPERTY(config, EditAnywhere, Category = "Setting", meta = (DisplayName = "Idle GC Time Budget (ms)", defaultValue = 0))
+    float IdleGCTimeBudgetMs = 0;
+
+    UPROPERTY(config, EditAnywhere, Category = "Setting", meta = (DisplayName = "Memory Pressure Threshold (MB)", defaultValue = 0))
+    int32 MemoryPressureThresholdMB = 0;
 };
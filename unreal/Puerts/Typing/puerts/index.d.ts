@@ -6,7 +6,7 @@
 */
 
 declare module "puerts" {
-    import {Object, Class, $Delegate} from "ue"
+    import {Object, Class, $Delegate, Function as UFunction} from "ue"
     
     interface $Ref<T> {
         value: T
@@ -44,6 +44,16 @@ declare module "puerts" {
     function toManualReleaseDelegate<T extends (...args: any) => any>(func: T): $Delegate<T>;
     
     function releaseManualReleaseDelegate<T extends (...args: any) => any>(func: T): void;
+    
+    function batchCall(fn: string | UFunction, targets: Object[], args?: ArrayLike<any>): any[] | undefined;
+    
+    //UE calls made directly inside fn return FVector/FRotator/FQuat/FTransform by value as Float32Array(32) or Float64Array(64), though the ue typings still say FVector etc.
+    //arguments of callbacks invoked from UE keep using wrapper objects
+    function mathStructTypedArrayScope<T>(mode: 32 | 64, fn: () => T): T;
+
+    //structs returned by value while fn runs live in a frame arena and are released (pointer nulled) when fn returns, do not keep them
+    //nested structs and fixed size arrays read from them are released too, reading a container or delegate member of them throws
+    function frameScope<T>(fn: () => T): T;
 
     /*function getProperties(obj: Object, ...propNames:string[]): any;
     function getPropertiesAsync(obj: Object, ...propNames:string[]): Promise<any>;
@@ -60,4 +70,4 @@ declare module "puerts" {
     function $async<T>(x: T) : AsyncObject<T>;*/
 }
 
-declare function require(name: string): any;
\ No newline at end of file
+declare function require(name: string): any;
\ No newline at end of file
@@ -24,6 +24,8 @@ declare module "ue" {
         Clear(): void;
     }
     
+    type $TypedArray = Int8Array | Uint8Array | Int16Array | Uint16Array | Int32Array | Uint32Array | Float32Array | Float64Array;
+    
     class FixSizeArray<T> {
         Num(): number;
         Get(Index: number): T;
@@ -40,6 +42,19 @@ declare module "ue" {
         RemoveAt(Index: number): void;
         IsValidIndex(Index: number): boolean;
         Empty(): void;
+        toTypedArray(): $TypedArray;
+        //only for arrays returned to js by value; throws for arrays accessed by pointer (e.g. obj.Arr), use toTypedArray for those
+        asTypedArrayView(): $TypedArray;
+        setFromTypedArray(Value: $TypedArray): void;
+        forEach(Callback: (Value: T, Index: number) => void): void;
+        toArray(): T[];
+        [Symbol.iterator](): IterableIterator<T>;
+        Reserve(Number: number): void;
+        Append(Other: TArray<T> | T[]): void;
+        SetNum(Number: number): void;
+        Shrink(): void;
+        //stable; without CompareFn numbers, FName and FString are sorted by their native <, NaN goes last
+        Sort(CompareFn?: (A: T, B: T) => number): void;
     }
     
     class TSet<T> {
@@ -53,6 +68,9 @@ declare module "ue" {
         GetMaxIndex(): number;  // TODO - GetMaxIndex的返回值是InvalidIndex，合理吗？（GetMaxIndex的解释应该是：最大合法index+1），当调用Empty，返回值为0
         IsValidIndex(Index: number): boolean;
         Empty(): void;
+        forEach(Callback: (Value: T) => void): void;
+        toArray(): T[];
+        [Symbol.iterator](): IterableIterator<T>;
     }
     
     class TMap<TKey, TValue> {
@@ -65,6 +83,10 @@ declare module "ue" {
         IsValidIndex(Index: number): boolean;
         GetKey(Index: number): TKey;            // TODO - 对于非法index，是否应该返回undefined
         Empty(): void;
+        forEach(Callback: (Value: TValue, Key: TKey) => void): void;
+        toArray(): [TKey, TValue][];
+        toJSMap(): Map<TKey, TValue>;
+        [Symbol.iterator](): IterableIterator<[TKey, TValue]>;
     }
 
         